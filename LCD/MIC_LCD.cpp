@@ -1,12 +1,17 @@
 #include "Arduino.h"
+#include <SPI.h>
+
+// Snapshot can be persisted to EEPROM if the board provides it
+#if defined(__has_include)
+#if __has_include(<EEPROM.h>)
+#include <EEPROM.h>
+#define MIC_LCD_EEPROM
+#endif
+#endif
 
 #include "MIC_GeneralDef.h"
 #include "MIC_LCD.h"
 
-// LCD layout support, set cursor needs to be modified if this is changed to more than 4 rows
-#define MIC_LCD_MAXCOLUMN		16
-#define MIC_LCD_MAXROW			4
-
 // LCD signal definition
 #define _RS_INSTRUCTION			LOW
 #define _RS_DATA				HIGH
@@ -15,6 +20,24 @@
 #define _EN_DISABLE				LOW
 #define _EN_ENABLE				HIGH
 
+// LCD bus transport
+#define MIC_LCD_BUS_PARALLEL	0		// RS, EN, RW and DB pins are driven directly
+#define MIC_LCD_BUS_SPI595		1		// 74HC595 shift register on hardware SPI
+
+// 74HC595 output assignment
+#define MIC_LCD_595_RS			0x02	// Q1
+#define MIC_LCD_595_EN			0x04	// Q2
+#define MIC_LCD_595_DBSHIFT		1		// DB7-DB4 (bit 7-4) are shifted down to Q6-Q3
+#define MIC_LCD_595_DBMASK		0x78	// Q6-Q3
+#define MIC_LCD_595_BACKLIGHT	0x80	// Q7
+#define MIC_LCD_595_SPICLOCK	4000000	// EN high lasts for one SPI byte (2us), PWEH = 450ns min
+
+// Instruction execution time for write only mode (us)
+// Datasheet times (1.52ms, 37us) are for fosc = 270kHz, execution time scales with 1 / fosc. Worst case is taken at
+// the lowest fosc of the datasheet (190kHz): 1.52ms * 270 / 190 = 2.16ms, 37us * 270 / 190 = 53us, plus tADD 4us.
+#define MIC_LCD_EXECTIME_LONG	2200	// Clear display and return home
+#define MIC_LCD_EXECTIME_SHORT	60		// All other instructions and data write
+
 // Instruction Description
 // Clear Display
 //      RS  R/W DB7 DB6 DB5 DB4 DB3 DB2 DB1 DB0
@@ -83,7 +106,83 @@
 #define MIC_LCD_INST_SETDDRAMADDR			0x80
 #define MIC_LCD_INST_SETDDRAMADDR_ADDRMASK	0x7F
 
+// DDRAM address range: 1-line mode 0x00 - 0x4F, 2-line mode 0x00 - 0x27 and 0x40 - 0x67
+#define MIC_LCD_DDRAM_1LINEEND		0x50
+#define MIC_LCD_DDRAM_LINESIZE		0x28
+#define MIC_LCD_DDRAM_LINE2			0x40
+
+// Built-in geometry profiles
+const MIC_LCD_GEOMETRY MIC_LCD_GEOMETRY_8X1 = {1, 8, {0x00, 0x00, 0x00, 0x00}, 0};
+const MIC_LCD_GEOMETRY MIC_LCD_GEOMETRY_8X2 = {2, 8, {0x00, 0x40, 0x00, 0x00}, 0};
+const MIC_LCD_GEOMETRY MIC_LCD_GEOMETRY_16X1 = {1, 16, {0x00, 0x00, 0x00, 0x00}, 0};
+const MIC_LCD_GEOMETRY MIC_LCD_GEOMETRY_16X1_SPLIT = {1, 16, {0x00, 0x00, 0x00, 0x00}, 8};
+const MIC_LCD_GEOMETRY MIC_LCD_GEOMETRY_16X2 = {2, 16, {0x00, 0x40, 0x00, 0x00}, 0};
+const MIC_LCD_GEOMETRY MIC_LCD_GEOMETRY_16X4 = {4, 16, {0x00, 0x40, 0x10, 0x50}, 0};
+const MIC_LCD_GEOMETRY MIC_LCD_GEOMETRY_20X2 = {2, 20, {0x00, 0x40, 0x00, 0x00}, 0};
+const MIC_LCD_GEOMETRY MIC_LCD_GEOMETRY_20X4 = {4, 20, {0x00, 0x40, 0x14, 0x54}, 0};
+const MIC_LCD_GEOMETRY MIC_LCD_GEOMETRY_24X2 = {2, 24, {0x00, 0x40, 0x00, 0x00}, 0};
+const MIC_LCD_GEOMETRY MIC_LCD_GEOMETRY_40X2 = {2, 40, {0x00, 0x40, 0x00, 0x00}, 0};
+
 // Private functions
+// Function: void _setRS(BYTE rs)
+// Set RS signal. For 74HC595, RS is latched out only when it changes to keep address set-up time.
+void MIC_LCD::_setRS(BYTE rs)
+{
+	BYTE shiftRegister = 0;
+
+	if (_LCD_Attributes._busMode == MIC_LCD_BUS_SPI595)
+	{
+		shiftRegister = _LCD_Attributes._shiftRegister & (~MIC_LCD_595_RS);
+
+		if (rs == _RS_DATA)
+		{
+			shiftRegister |= MIC_LCD_595_RS;
+		}
+
+		if (shiftRegister != _LCD_Attributes._shiftRegister)
+		{
+			_LCD_Attributes._shiftRegister = shiftRegister;
+
+			SPI.beginTransaction(SPISettings(MIC_LCD_595_SPICLOCK, MSBFIRST, SPI_MODE0));
+			_latch(shiftRegister);
+			SPI.endTransaction();
+		}
+	}
+	else
+	{
+		digitalWrite(_LCD_Attributes._RS_PIN, rs);
+	}
+
+	return;
+}
+
+// Function: void _latch(BYTE value)
+// 74HC595 only: shift one byte through SPI and latch it to the outputs.
+void MIC_LCD::_latch(BYTE value)
+{
+	SPI.transfer(value);
+
+	digitalWrite(_LCD_Attributes._LATCH_PIN, HIGH);
+	digitalWrite(_LCD_Attributes._LATCH_PIN, LOW);
+
+	return;
+}
+
+// Function: void _shiftBits(BYTE bitsWritten)
+// 74HC595 only: higher 4 bits are latched out twice back to back, with EN high and EN low.
+// Caller should begin SPI transaction.
+void MIC_LCD::_shiftBits(BYTE bitsWritten)
+{
+	BYTE value = 0;
+
+	value = _LCD_Attributes._shiftRegister | ((bitsWritten >> MIC_LCD_595_DBSHIFT) & MIC_LCD_595_DBMASK);
+
+	_latch(value | MIC_LCD_595_EN);		// EN high, data setup time is covered by the second SPI byte
+	_latch(value);						// EN low, data is held
+
+	return;
+}
+
 // Function: BYTE _readBits (void)
 // For 4 bits bus mode, DB7 - 4 are read to higher 4 bits;
 // For 8 bits bus mode, all bits are read out.
@@ -152,7 +251,19 @@ void MIC_LCD::_writeBits(BYTE bitsWritten)
 {
 	BYTE counter = 0;
 
-	digitalWrite(_LCD_Attributes._RW_PIN, _RW_WRITE);
+	if (_LCD_Attributes._busMode == MIC_LCD_BUS_SPI595)
+	{
+		SPI.beginTransaction(SPISettings(MIC_LCD_595_SPICLOCK, MSBFIRST, SPI_MODE0));
+		_shiftBits(bitsWritten);
+		SPI.endTransaction();
+
+		return;
+	}
+
+	if (_LCD_Attributes._RW_PIN != 0xff)
+	{
+		digitalWrite(_LCD_Attributes._RW_PIN, _RW_WRITE);
+	}
 	delayMicroseconds(1); // Address set-up time, (RS, R/#W to E, tAS = 40ns min)
 
 	digitalWrite(_LCD_Attributes._EN_PIN, _EN_ENABLE);
@@ -175,6 +286,17 @@ void MIC_LCD::_writeBits(BYTE bitsWritten)
 // Function: void _writeBYTE (BYTE byte)
 void MIC_LCD::_writeBYTE(BYTE byte)
 {
+	if (_LCD_Attributes._busMode == MIC_LCD_BUS_SPI595)
+	{
+		// Both nibbles with their EN strobes are sent in one SPI burst
+		SPI.beginTransaction(SPISettings(MIC_LCD_595_SPICLOCK, MSBFIRST, SPI_MODE0));
+		_shiftBits(byte);
+		_shiftBits((byte & 0x0f) << 4);
+		SPI.endTransaction();
+
+		return;
+	}
+
 	_writeBits(byte);
 
 	if (_LCD_Attributes._functionSet._8BitBus == CLEAR)
@@ -190,7 +312,7 @@ MIC_LCD_STATUS MIC_LCD::_readStatus (void)
 {
 	BYTE byteRead;
 
-	digitalWrite(_LCD_Attributes._RS_PIN, _RS_INSTRUCTION);
+	_setRS(_RS_INSTRUCTION);
 
 	byteRead = _readBYTE();
 
@@ -198,29 +320,304 @@ MIC_LCD_STATUS MIC_LCD::_readStatus (void)
 }
 
 // Function: MIC_RC _LCD_Ready(void);
-// Return MIC_RC_SUCCESS on ready. Error when time out (set to 1024ms)
+// Return MIC_RC_SUCCESS on ready. Error when busy flag is still set after busy timeout (us).
+// After a time out the LCD is marked failed and all later calls fail immediately, until checkHealth or PORST
+// brings it back. In write only mode, wait until execution time of the last instruction/data has passed.
 MIC_RC MIC_LCD::_LCDReady(void)
 {
 	MIC_RC returnCode = MIC_RC_SUCCESS;
 	MIC_LCD_STATUS status = {0, SET};
-	unsigned long currentMillis = 0;
+	unsigned long startMicros = 0;
+	BYTE timedOut = CLEAR;
 
-	status = _readStatus();
+	if (_LCD_Attributes._writeOnly == SET)
+	{
+		while ((micros() - _LCD_Attributes._lastWrite) < _LCD_Attributes._execTime)
+		{
+		}
+
+		return returnCode;
+	}
 
-	currentMillis = (millis() / 1000);		// time out set to 1000 ms
-	while ((status.busy == SET) && (returnCode == MIC_RC_SUCCESS) && (currentMillis == (millis() / 1000)))
+	if (_LCD_Attributes._health.state == MIC_LCD_HEALTH_FAILED)
 	{
-		status = _readStatus();
+		return MIC_RC_LCD_ERROR;
 	}
 
+	// Time is taken before each read, so the last read is done after the time out even when an interrupt delayed it
+	startMicros = micros();
+
+	do
+	{
+		timedOut = ((micros() - startMicros) >= _LCD_Attributes._busyTimeout) ? SET : CLEAR;
+		status = _readStatus();
+	} while ((status.busy == SET) && (timedOut == CLEAR));
+
 	if (status.busy == SET)
+	{
+		_LCD_Attributes._health.state = MIC_LCD_HEALTH_FAILED;
+		_LCD_Attributes._health.timeoutCount++;
+		_LCD_Attributes._lastProbe = millis();
+
+		// LCD may have lost power or bus sync, AC is not known any more
+		_LCD_Attributes._ACValid = CLEAR;
+
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+
+	return returnCode;
+}
+
+// Function: void _trackAC(BYTE rs, BYTE value)
+// Follow address counter changes made by an instruction or a data read/write
+// Instruction: clear display, return home, cursor shift, set CGRAM and DDRAM address
+// Data: AC steps by entry mode, DDRAM address wraps at the end of a line (0x27 -> 0x40, 0x67 -> 0x00 in 2-line mode)
+// AC is known after an instruction setting it absolutely, a function set makes it unknown.
+void MIC_LCD::_trackAC(BYTE rs, BYTE value)
+{
+	BYTE shiftRight = _LCD_Attributes._entryModeSet._shiftRight;
+	BYTE step = SET;
+
+	if (rs == _RS_INSTRUCTION)
+	{
+		step = CLEAR;
+
+		if ((value & MIC_LCD_INST_SETDDRAMADDR) != 0)
+		{
+			_LCD_Attributes._AC = value & MIC_LCD_INST_SETDDRAMADDR_ADDRMASK;
+			_LCD_Attributes._CGRAMSelected = CLEAR;
+			_LCD_Attributes._ACValid = SET;
+		}
+		else if ((value & MIC_LCD_INST_SETCGRAMADDR) != 0)
+		{
+			_LCD_Attributes._AC = value & MIC_LCD_INST_SETCGRAMADDR_ADDRMASK;
+			_LCD_Attributes._CGRAMSelected = SET;
+			_LCD_Attributes._ACValid = SET;
+		}
+		else if ((value & 0xe0) == 0x20)
+		{
+			_LCD_Attributes._ACValid = CLEAR;
+		}
+		else if ((value & 0xf8) == 0x10)
+		{
+			// Cursor shift (S/C = 0), display shift does not change AC
+			shiftRight = (value >> 2) & 0x01;
+			step = SET;
+		}
+		else if ((value & 0xfc) == 0)
+		{
+			// Clear display and return home, clear display also sets entry mode to increment (I/D = 1)
+			_LCD_Attributes._AC = 0;
+			_LCD_Attributes._CGRAMSelected = CLEAR;
+			_LCD_Attributes._ACValid = SET;
+
+			if (value == MIC_LCD_INST_CLEARDISPLAY)
+			{
+				_LCD_Attributes._entryModeSet._shiftRight = SET;
+			}
+		}
+	}
+
+	if (step == SET)
+	{
+		if (_LCD_Attributes._CGRAMSelected == SET)
+		{
+			_LCD_Attributes._AC = (_LCD_Attributes._AC + ((shiftRight == SET) ? 1 : -1)) & MIC_LCD_INST_SETCGRAMADDR_ADDRMASK;
+		}
+		else if (_LCD_Attributes._functionSet._2LineMode == SET)
+		{
+			if (shiftRight == SET)
+			{
+				_LCD_Attributes._AC = (_LCD_Attributes._AC == 0x27) ? 0x40 : ((_LCD_Attributes._AC == 0x67) ? 0x00 : (_LCD_Attributes._AC + 1));
+			}
+			else
+			{
+				_LCD_Attributes._AC = (_LCD_Attributes._AC == 0x40) ? 0x27 : ((_LCD_Attributes._AC == 0x00) ? 0x67 : (_LCD_Attributes._AC - 1));
+			}
+		}
+		else
+		{
+			if (shiftRight == SET)
+			{
+				_LCD_Attributes._AC = (_LCD_Attributes._AC == 0x4f) ? 0x00 : (_LCD_Attributes._AC + 1);
+			}
+			else
+			{
+				_LCD_Attributes._AC = (_LCD_Attributes._AC == 0x00) ? 0x4f : (_LCD_Attributes._AC - 1);
+			}
+		}
+	}
+
+	if (_LCD_Attributes._snapshot != NULL)
+	{
+		_LCD_Attributes._snapshot->AC = _LCD_Attributes._AC;
+		_LCD_Attributes._snapshot->CGRAMSelected = _LCD_Attributes._CGRAMSelected;
+		_LCD_Attributes._snapshot->entryModeSet = *((BYTE*)&_LCD_Attributes._entryModeSet);
+	}
+
+	return;
+}
+
+// Function: MIC_RC _buildCellMap(const MIC_LCD_GEOMETRY *geometry)
+// Validate geometry and fill cell address map, map is kept if geometry is not valid
+// First pass checks every address is in DDRAM of the line mode and used once, second pass fills the map.
+MIC_RC MIC_LCD::_buildCellMap(const MIC_LCD_GEOMETRY *geometry)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	BYTE used[(MIC_LCD_INST_SETDDRAMADDR_ADDRMASK + 1) / 8];	// one bit per DDRAM address
+	BYTE twoLine = CLEAR;
+	BYTE pass = 0;
+	BYTE row = 0;
+	BYTE column = 0;
+	BYTE cell = 0;
+	BYTE address = 0;
+
+	memset(used, 0, sizeof(used));
+
+	if ((geometry->rows == 0) || (geometry->rows > MIC_LCD_MAXROW) ||
+	(geometry->columns == 0) || (geometry->columns > MIC_LCD_MAXCOLUMN) ||
+	((geometry->rows * geometry->columns) > MIC_LCD_MAXCELLS) || (geometry->splitColumn >= geometry->columns))
 	{
 		returnCode = MIC_RC_LCD_ERROR;
 	}
 
+	twoLine = ((geometry->rows > 1) || (geometry->splitColumn != 0)) ? SET : CLEAR;
+
+	for (pass = 0; (pass < 2) && (returnCode == MIC_RC_SUCCESS); pass++)
+	{
+		cell = 0;
+
+		for (row = 0; (row < geometry->rows) && (returnCode == MIC_RC_SUCCESS); row++)
+		{
+			for (column = 0; (column < geometry->columns) && (returnCode == MIC_RC_SUCCESS); column++)
+			{
+				address = geometry->rowOffset[row] + column;
+
+				if ((geometry->splitColumn != 0) && (column >= geometry->splitColumn))
+				{
+					address = geometry->rowOffset[row] + MIC_LCD_DDRAM_LINE2 + (column - geometry->splitColumn);
+				}
+
+				if (pass == 1)
+				{
+					_LCD_Attributes._cellAddr[cell] = address;
+				}
+				else if (((twoLine == SET) && (address >= MIC_LCD_DDRAM_LINESIZE) &&
+				((address < MIC_LCD_DDRAM_LINE2) || (address >= (MIC_LCD_DDRAM_LINE2 + MIC_LCD_DDRAM_LINESIZE)))) ||
+				((twoLine == CLEAR) && (address >= MIC_LCD_DDRAM_1LINEEND)) ||
+				((used[address >> 3] & (1 << (address & 0x07))) != 0))
+				{
+					returnCode = MIC_RC_LCD_ERROR;
+				}
+				else
+				{
+					used[address >> 3] |= (1 << (address & 0x07));
+				}
+
+				cell++;
+			}
+		}
+	}
+
+	if (returnCode == MIC_RC_SUCCESS)
+	{
+		_LCD_Attributes._geometry = *geometry;
+	}
+
+	return returnCode;
+}
+
+// Function: MIC_RC _setCell(BYTE cell)
+// Move AC to a cell (row * columns + column, starts from 0) without boundary check.
+// Set address instruction is skipped when AC already points to the cell, so consecutive cells are written in
+// one run and a new address is set only where the next cell is not next in DDRAM (e.g. split rows).
+// It is never skipped while AC is not known (before PORST, after a function set or a busy time out).
+MIC_RC MIC_LCD::_setCell(BYTE cell)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	BYTE address = _LCD_Attributes._cellAddr[cell];
+
+	if ((_LCD_Attributes._ACValid == CLEAR) || (address != _LCD_Attributes._AC) ||
+	(_LCD_Attributes._CGRAMSelected == SET))
+	{
+		returnCode = _writeInstruction(MIC_LCD_INST_SETDDRAMADDR + address);
+	}
+
 	return returnCode;
 }
 
+// Function: void _mirror(BYTE rs, BYTE value)
+// Mirror an instruction or data write into the attached snapshot, called before AC is updated
+// Instructions refresh the mode registers, clear display fills DDRAM with space.
+void MIC_LCD::_mirror(BYTE rs, BYTE value)
+{
+	MIC_LCD_SNAPSHOT *snapshot = _LCD_Attributes._snapshot;
+	BYTE AC = _LCD_Attributes._AC;
+	BYTE index = MIC_LCD_DDRAMSIZE;
+
+	if (snapshot == NULL)
+	{
+		return;
+	}
+
+	if (rs == _RS_INSTRUCTION)
+	{
+		if (value == MIC_LCD_INST_CLEARDISPLAY)
+		{
+			memset(snapshot->DDRAM, 0x20, MIC_LCD_DDRAMSIZE);
+		}
+
+		snapshot->row = _LCD_Attributes._row;
+		snapshot->column = _LCD_Attributes._column;
+		snapshot->entryModeSet = *((BYTE*)&_LCD_Attributes._entryModeSet);
+		snapshot->displayONOFF = *((BYTE*)&_LCD_Attributes._displayONOFF);
+		snapshot->functionSet = *((BYTE*)&_LCD_Attributes._functionSet);
+	}
+	else if (_LCD_Attributes._CGRAMSelected == SET)
+	{
+		snapshot->CGRAM[AC & MIC_LCD_INST_SETCGRAMADDR_ADDRMASK] = value;
+	}
+	else
+	{
+		if (_LCD_Attributes._functionSet._2LineMode == CLEAR)
+		{
+			index = AC;
+		}
+		else if (AC < 0x28)
+		{
+			index = AC;
+		}
+		else if ((AC >= 0x40) && (AC < 0x68))
+		{
+			index = AC - 0x40 + (MIC_LCD_DDRAMSIZE / 2);
+		}
+
+		if (index < MIC_LCD_DDRAMSIZE)
+		{
+			snapshot->DDRAM[index] = value;
+		}
+	}
+
+	return;
+}
+
+// Function: BYTE _snapshotChecksum(MIC_LCD_SNAPSHOT *snapshot)
+// Return checksum that makes all bytes before it add up to 0
+BYTE MIC_LCD::_snapshotChecksum(MIC_LCD_SNAPSHOT *snapshot)
+{
+	BYTE *bytes = (BYTE*)snapshot;
+	BYTE sum = 0;
+	UINT16 counter = 0;
+	UINT16 length = (UINT16)(&snapshot->checksum - bytes);
+
+	for (counter = 0; counter < length; counter++)
+	{
+		sum += bytes[counter];
+	}
+
+	return (BYTE)(0 - sum);
+}
+
 // Function: MIC_RC _write_Instruction (BYTE instruction)
 // Input: instruction byte pointer
 MIC_RC MIC_LCD::_writeInstruction (BYTE instruction)
@@ -231,8 +628,17 @@ MIC_RC MIC_LCD::_writeInstruction (BYTE instruction)
 
 	if (returnCode == MIC_RC_SUCCESS)
 	{
-		digitalWrite(_LCD_Attributes._RS_PIN, _RS_INSTRUCTION);
+		_setRS(_RS_INSTRUCTION);
 		_writeBYTE(instruction);
+		_mirror(_RS_INSTRUCTION, instruction);
+		_trackAC(_RS_INSTRUCTION, instruction);
+
+		if (_LCD_Attributes._writeOnly == SET)
+		{
+			// Clear display (0x01) and return home (0x02/0x03) are the only long instructions
+			_LCD_Attributes._execTime = ((instruction & 0xfc) == 0) ? MIC_LCD_EXECTIME_LONG : MIC_LCD_EXECTIME_SHORT;
+			_LCD_Attributes._lastWrite = micros();
+		}
 	}
 
 	return returnCode;
@@ -245,12 +651,20 @@ MIC_RC MIC_LCD::_readData (BYTE *data)
 	MIC_RC returnCode = MIC_RC_SUCCESS;
 	BYTE dataRead;
 
-	returnCode = _LCDReady();
+	if (_LCD_Attributes._writeOnly == SET)
+	{
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+	else
+	{
+		returnCode = _LCDReady();
+	}
 
 	if (returnCode == MIC_RC_SUCCESS)
 	{
-		digitalWrite(_LCD_Attributes._RS_PIN, _RS_DATA);
+		_setRS(_RS_DATA);
 		*data = _readBYTE();
+		_trackAC(_RS_DATA, *data);
 	}
 
 	return returnCode;
@@ -266,8 +680,16 @@ MIC_RC MIC_LCD::_writeData (BYTE data)
 
 	if (returnCode == MIC_RC_SUCCESS)
 	{
-		digitalWrite(_LCD_Attributes._RS_PIN, _RS_DATA);
+		_setRS(_RS_DATA);
 		_writeBYTE(data);
+		_mirror(_RS_DATA, data);
+		_trackAC(_RS_DATA, data);
+
+		if (_LCD_Attributes._writeOnly == SET)
+		{
+			_LCD_Attributes._execTime = MIC_LCD_EXECTIME_SHORT;
+			_LCD_Attributes._lastWrite = micros();
+		}
 	}
 
 	return returnCode;
@@ -275,9 +697,11 @@ MIC_RC MIC_LCD::_writeData (BYTE data)
 
 // Public functions
 //Function: MIC_LCD (	BYTE RS, BYTE EN, BYTE RW,
-//						BYTE DB7, BYTE DB6, BYTE DB5, BYTE DB4, BYTE DB3, BYTE DB2, BYTE DB1, BYTE DB0)
+//						BYTE DB7, BYTE DB6, BYTE DB5, BYTE DB4, BYTE DB3, BYTE DB2, BYTE DB1, BYTE DB0,
+//						const MIC_LCD_GEOMETRY *geometry)
 MIC_LCD::MIC_LCD (	BYTE RS, BYTE EN, BYTE RW,
-BYTE DB7, BYTE DB6, BYTE DB5, BYTE DB4, BYTE DB3, BYTE DB2, BYTE DB1, BYTE DB0)
+BYTE DB7, BYTE DB6, BYTE DB5, BYTE DB4, BYTE DB3, BYTE DB2, BYTE DB1, BYTE DB0,
+const MIC_LCD_GEOMETRY *geometry)
 {
 	//Function pins
 	_LCD_Attributes._RS_PIN = RS;
@@ -293,6 +717,75 @@ BYTE DB7, BYTE DB6, BYTE DB5, BYTE DB4, BYTE DB3, BYTE DB2, BYTE DB1, BYTE DB0)
 	_LCD_Attributes._DB_PIN[5] = DB5;
 	_LCD_Attributes._DB_PIN[6] = DB6;
 	_LCD_Attributes._DB_PIN[7] = DB7;
+	_LCD_Attributes._LATCH_PIN = 0xff;
+
+	//Bus setup, R/#W tied to GND can only be written
+	_LCD_Attributes._busMode = MIC_LCD_BUS_PARALLEL;
+	_LCD_Attributes._writeOnly = (RW == 0xff) ? SET : CLEAR;
+	_LCD_Attributes._shiftRegister = 0x00;
+
+	_initAttributes(geometry);
+
+	return;
+}
+
+//Function: MIC_LCD (BYTE LATCH, const MIC_LCD_GEOMETRY *geometry)
+MIC_LCD::MIC_LCD (BYTE LATCH, const MIC_LCD_GEOMETRY *geometry)
+{
+	BYTE counter = 0;
+
+	//Function pins are outputs of 74HC595
+	_LCD_Attributes._RS_PIN = 0xff;
+	_LCD_Attributes._EN_PIN = 0xff;
+	_LCD_Attributes._RW_PIN = 0xff;
+
+	//DB pins are outputs of 74HC595, DB3 - DB0 are not connected (4 bit bus)
+	for (counter = 0; counter < 8; counter++)
+	{
+		_LCD_Attributes._DB_PIN[counter] = 0xff;
+	}
+	_LCD_Attributes._LATCH_PIN = LATCH;
+
+	//Bus setup, always write only
+	_LCD_Attributes._busMode = MIC_LCD_BUS_SPI595;
+	_LCD_Attributes._writeOnly = SET;
+	_LCD_Attributes._shiftRegister = MIC_LCD_595_BACKLIGHT;
+
+	_initAttributes(geometry);
+
+	return;
+}
+
+//Function: void _initAttributes (const MIC_LCD_GEOMETRY *geometry)
+//Default instruction attributes shared by all bus modes
+void MIC_LCD::_initAttributes (const MIC_LCD_GEOMETRY *geometry)
+{
+	_LCD_Attributes._execTime = 0;
+	_LCD_Attributes._lastWrite = 0;
+	_LCD_Attributes._row = 0;
+	_LCD_Attributes._column = 0;
+
+	// Cell address map is ready before PORST, 16x2 is used until geometry is set
+	_LCD_Attributes._geometrySet = CLEAR;
+	_buildCellMap(&MIC_LCD_GEOMETRY_16X2);
+
+	if (geometry != NULL)
+	{
+		setGeometry(geometry);
+	}
+
+	_LCD_Attributes._AC = 0;
+	_LCD_Attributes._CGRAMSelected = CLEAR;
+	_LCD_Attributes._ACValid = CLEAR;
+	_LCD_Attributes._snapshot = NULL;
+
+	_LCD_Attributes._busyTimeout = MIC_LCD_BUSYTIMEOUT;
+	_LCD_Attributes._probeInterval = MIC_LCD_PROBEINTERVAL;
+	_LCD_Attributes._lastProbe = 0;
+	_LCD_Attributes._health.state = MIC_LCD_HEALTH_OK;
+	_LCD_Attributes._health.timeoutCount = 0;
+	_LCD_Attributes._health.recoveryCount = 0;
+	_LCD_Attributes._health.failedProbeCount = 0;
 
 	//Function setup
 	_LCD_Attributes._functionSet._2LineMode = SET;
@@ -324,11 +817,30 @@ MIC_RC MIC_LCD::PORST (BYTE row, BYTE column)
 {
 	MIC_RC returnCode = MIC_RC_SUCCESS;
 	BYTE counter = 0;
+	MIC_LCD_GEOMETRY geometry;
 
 	// Set up PIN input/output mode
-	pinMode(_LCD_Attributes._RS_PIN, OUTPUT);
-	pinMode(_LCD_Attributes._EN_PIN, OUTPUT);
-	pinMode(_LCD_Attributes._RW_PIN, OUTPUT);
+	if (_LCD_Attributes._busMode == MIC_LCD_BUS_SPI595)
+	{
+		pinMode(_LCD_Attributes._LATCH_PIN, OUTPUT);
+		digitalWrite(_LCD_Attributes._LATCH_PIN, LOW);
+		SPI.begin();
+
+		// RS = instruction, EN = low, backlight on
+		SPI.beginTransaction(SPISettings(MIC_LCD_595_SPICLOCK, MSBFIRST, SPI_MODE0));
+		_latch(_LCD_Attributes._shiftRegister);
+		SPI.endTransaction();
+	}
+	else
+	{
+		pinMode(_LCD_Attributes._RS_PIN, OUTPUT);
+		pinMode(_LCD_Attributes._EN_PIN, OUTPUT);
+
+		if (_LCD_Attributes._RW_PIN != 0xff)
+		{
+			pinMode(_LCD_Attributes._RW_PIN, OUTPUT);
+		}
+	}
 
 	for (counter = 0; counter <8; counter++)
 	{
@@ -338,27 +850,53 @@ MIC_RC MIC_LCD::PORST (BYTE row, BYTE column)
 		}
 	}
 
-	// Set row and column
-	if ((row > MIC_LCD_MAXROW) || (column > MIC_LCD_MAXCOLUMN))
+	// Set row and column: geometry set by application has to match them, standard layout when none is set
+	if ((_LCD_Attributes._geometrySet == SET) &&
+	((_LCD_Attributes._geometry.rows != row) || (_LCD_Attributes._geometry.columns != column)))
 	{
 		returnCode = MIC_RC_LCD_ERROR;
 	}
-	else
+	else if (_LCD_Attributes._geometrySet == CLEAR)
+	{
+		geometry.rows = row;
+		geometry.columns = column;
+		geometry.rowOffset[0] = 0x00;
+		geometry.rowOffset[1] = MIC_LCD_DDRAM_LINE2;
+		geometry.rowOffset[2] = column;
+		geometry.rowOffset[3] = MIC_LCD_DDRAM_LINE2 + column;
+		geometry.splitColumn = 0;
+
+		returnCode = _buildCellMap(&geometry);
+	}
+
+	if (returnCode == MIC_RC_SUCCESS)
 	{
 		_LCD_Attributes._row = row;
 		_LCD_Attributes._column = column;
 
-		if (row == 1)
+		if ((row == 1) && (_LCD_Attributes._geometry.splitColumn == 0))
 		{
 			// Set LCD to 1 line mode and try to use a bigger font
 			_LCD_Attributes._functionSet._2LineMode = CLEAR;
 			_LCD_Attributes._functionSet._5x11Format = SET;
 		}
+		else
+		{
+			_LCD_Attributes._functionSet._2LineMode = SET;
+			_LCD_Attributes._functionSet._5x11Format = CLEAR;
+		}
+
+		// Interface is set to 8-bit first, also when PORST runs again on a 4-bit bus
+		_LCD_Attributes._functionSet._8BitBus = SET;
+
+		// Busy flag is polled again during initialization, a time out marks the LCD failed
+		_LCD_Attributes._health.state = MIC_LCD_HEALTH_RECOVERING;
+		_LCD_Attributes._ACValid = CLEAR;
 
 		// Wait 40ms, after VCC rises to 2.7V, use 50ms
 		delay(50);
 
-		digitalWrite(_LCD_Attributes._RS_PIN, _RS_INSTRUCTION);
+		_setRS(_RS_INSTRUCTION);
 
 		// Do not check busy flag, set 8-bit interface
 		_writeBits(*((BYTE*)&_LCD_Attributes._functionSet));
@@ -375,6 +913,9 @@ MIC_RC MIC_LCD::PORST (BYTE row, BYTE column)
 		// Do not check busy flag, set 8-bit interface
 		_writeBits(*((BYTE*)&_LCD_Attributes._functionSet));
 
+		// Wait execution time of the function set, busy flag can not be checked yet
+		delayMicroseconds(MIC_LCD_EXECTIME_SHORT);
+
 		// Do not check busy flag, set interface based on DB pin assignment
 		// Any pin assignment of DB3 - DB0 will define bus mode as 8 pin.
 		if ((_LCD_Attributes._DB_PIN[3] == 0xff) || (_LCD_Attributes._DB_PIN[2] == 0xff) ||
@@ -385,6 +926,10 @@ MIC_RC MIC_LCD::PORST (BYTE row, BYTE column)
 			_writeBits(*((BYTE*)&_LCD_Attributes._functionSet));
 		}
 
+		// Write only mode: the interface instructions above need their execution time
+		_LCD_Attributes._execTime = MIC_LCD_EXECTIME_SHORT;
+		_LCD_Attributes._lastWrite = micros();
+
 		// Set display row and font
 		returnCode = _writeInstruction(*((BYTE*)&_LCD_Attributes._functionSet));
 
@@ -407,6 +952,11 @@ MIC_RC MIC_LCD::PORST (BYTE row, BYTE column)
 		}
 
 		delay(2);
+
+		if (returnCode == MIC_RC_SUCCESS)
+		{
+			_LCD_Attributes._health.state = MIC_LCD_HEALTH_OK;
+		}
 	}
 
 	return returnCode;
@@ -565,31 +1115,29 @@ MIC_RC MIC_LCD::displayShiftRIGHT (void)
 //Input: column number and row number (all starts from 1)
 MIC_RC MIC_LCD::setCursor (BYTE row, BYTE column)
 {
-	const BYTE AC_baseAddr[4] = {0, 0x40, 0x14, 0x54};
 	MIC_RC returnCode = MIC_RC_SUCCESS;
-	BYTE AC = 0;
-	BYTE instruciton = 0;
 
-	if ((column > _LCD_Attributes._column) || (row > _LCD_Attributes._row))
+	if ((row == 0) || (column == 0) || (column > _LCD_Attributes._column) || (row > _LCD_Attributes._row))
 	{
 		returnCode = MIC_RC_LCD_ERROR;
 	}
 	else
 	{
-		AC = AC_baseAddr[(row - 1)] + (column - 1);
-		returnCode = _writeInstruction(MIC_LCD_INST_SETDDRAMADDR + (AC & MIC_LCD_INST_SETDDRAMADDR_ADDRMASK));
+		returnCode = _setCell((row - 1) * _LCD_Attributes._column + (column - 1));
 	}
 
 	return returnCode;
 }
 
 //Show a string from a specific screen location
+//Boundary is checked once, characters are written by cell address map
 MIC_RC MIC_LCD::displayStr (BYTE row, BYTE column, CHAR8* string, BYTE strLen)
 {
 	MIC_RC returnCode = MIC_RC_SUCCESS;
-	INT8 counter = 0;
+	BYTE counter = 0;
+	BYTE cell = 0;
 
-	if ((row > _LCD_Attributes._row) || ((column + strLen - 1) > _LCD_Attributes._column))
+	if ((row == 0) || (column == 0) || (row > _LCD_Attributes._row) || ((column + strLen - 1) > _LCD_Attributes._column))
 	{
 		returnCode = MIC_RC_LCD_ERROR;
 	}
@@ -601,13 +1149,12 @@ MIC_RC MIC_LCD::displayStr (BYTE row, BYTE column, CHAR8* string, BYTE strLen)
 
 	if (returnCode == MIC_RC_SUCCESS)
 	{
-		returnCode = setCursor(row, column);
-	}
+		cell = (row - 1) * _LCD_Attributes._column + (column - 1);
 
-	if (returnCode == MIC_RC_SUCCESS)
-	{
-		for (counter = 0; counter < strLen; counter++)
+		for (counter = 0; (counter < strLen) && (returnCode == MIC_RC_SUCCESS); counter++)
 		{
+			returnCode = _setCell(cell + counter);
+
 			if (returnCode == MIC_RC_SUCCESS)
 			{
 				returnCode = _writeData(string[counter]);
@@ -658,3 +1205,499 @@ MIC_RC MIC_LCD::displayTime(BYTE row, BYTE column, BYTE hr, BYTE min, BYTE sec)
 
 	return returnCode;
 }
+
+// Function: MIC_RC putChar (BYTE character)
+MIC_RC MIC_LCD::putChar(BYTE character)
+{
+	return _writeData(character);
+}
+
+// Function: MIC_RC displayDiff (BYTE row, BYTE column, CHAR8 *string, CHAR8 *shadow, BYTE strLen)
+// Cursor is set only when skipping unchanged characters, consecutive changes are written in one run.
+MIC_RC MIC_LCD::displayDiff(BYTE row, BYTE column, CHAR8 *string, CHAR8 *shadow, BYTE strLen)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	BYTE counter = 0;
+	BYTE cell = 0;
+
+	if ((row == 0) || (column == 0) || (row > _LCD_Attributes._row) || ((column + strLen - 1) > _LCD_Attributes._column))
+	{
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+	else
+	{
+		cell = (row - 1) * _LCD_Attributes._column + (column - 1);
+	}
+
+	for (counter = 0; (counter < strLen) && (returnCode == MIC_RC_SUCCESS); counter++)
+	{
+		if (string[counter] != shadow[counter])
+		{
+			returnCode = _setCell(cell + counter);
+
+			if (returnCode == MIC_RC_SUCCESS)
+			{
+				returnCode = _writeData(string[counter]);
+			}
+
+			if (returnCode == MIC_RC_SUCCESS)
+			{
+				shadow[counter] = string[counter];
+			}
+		}
+	}
+
+	return returnCode;
+}
+
+// Function: MIC_RC displayFrame (CHAR8 *frame, CHAR8 *shadow, BYTE *shadowValid)
+// Frame and shadow are indexed by cell, consecutive changes are written in one run.
+MIC_RC MIC_LCD::displayFrame(CHAR8 *frame, CHAR8 *shadow, BYTE *shadowValid)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	BYTE cells = _LCD_Attributes._row * _LCD_Attributes._column;
+	BYTE cell = 0;
+
+	if (cells == 0)
+	{
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+
+	for (cell = 0; (cell < cells) && (returnCode == MIC_RC_SUCCESS); cell++)
+	{
+		if ((*shadowValid == CLEAR) || (frame[cell] != shadow[cell]))
+		{
+			returnCode = _setCell(cell);
+
+			if (returnCode == MIC_RC_SUCCESS)
+			{
+				returnCode = _writeData(frame[cell]);
+			}
+
+			if (returnCode == MIC_RC_SUCCESS)
+			{
+				shadow[cell] = frame[cell];
+			}
+		}
+	}
+
+	*shadowValid = (returnCode == MIC_RC_SUCCESS) ? SET : CLEAR;
+
+	return returnCode;
+}
+
+// Function: MIC_RC setGeometry (const MIC_LCD_GEOMETRY *geometry)
+// Rows and columns are cleared until PORST sets the line mode for the new geometry.
+MIC_RC MIC_LCD::setGeometry(const MIC_LCD_GEOMETRY *geometry)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+
+	if (geometry == NULL)
+	{
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+	else
+	{
+		returnCode = _buildCellMap(geometry);
+	}
+
+	if (returnCode == MIC_RC_SUCCESS)
+	{
+		_LCD_Attributes._geometrySet = SET;
+		_LCD_Attributes._row = 0;
+		_LCD_Attributes._column = 0;
+	}
+
+	return returnCode;
+}
+
+// Function: BYTE getRow (void)
+BYTE MIC_LCD::getRow(void)
+{
+	return _LCD_Attributes._row;
+}
+
+// Function: BYTE getColumn (void)
+BYTE MIC_LCD::getColumn(void)
+{
+	return _LCD_Attributes._column;
+}
+
+// Function: MIC_RC createChar (BYTE slot, BYTE *glyph)
+// CGRAM is written through its own address with increment entry mode, entry mode and DDRAM address (cursor) are
+// restored afterward.
+MIC_RC MIC_LCD::createChar(BYTE slot, BYTE *glyph)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	BYTE counter = 0;
+	BYTE DDRAMAddr = _LCD_Attributes._AC;
+	BYTE CGRAMSelected = _LCD_Attributes._CGRAMSelected;
+	BYTE decrement = (_LCD_Attributes._entryModeSet._shiftRight == CLEAR) ? SET : CLEAR;
+
+	if (slot >= MIC_LCD_CGRAMSLOTS)
+	{
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+	else if (decrement == SET)
+	{
+		_LCD_Attributes._entryModeSet._shiftRight = SET;
+		returnCode = _writeInstruction(*((BYTE*)&_LCD_Attributes._entryModeSet));
+	}
+
+	if (returnCode == MIC_RC_SUCCESS)
+	{
+		returnCode = _writeInstruction(MIC_LCD_INST_SETCGRAMADDR + ((slot * MIC_LCD_CGRAMGLYPHSIZE) & MIC_LCD_INST_SETCGRAMADDR_ADDRMASK));
+	}
+
+	for (counter = 0; (counter < MIC_LCD_CGRAMGLYPHSIZE) && (returnCode == MIC_RC_SUCCESS); counter++)
+	{
+		returnCode = _writeData(glyph[counter] & 0x1f);
+	}
+
+	if (decrement == SET)
+	{
+		_LCD_Attributes._entryModeSet._shiftRight = CLEAR;
+
+		if (returnCode == MIC_RC_SUCCESS)
+		{
+			returnCode = _writeInstruction(*((BYTE*)&_LCD_Attributes._entryModeSet));
+		}
+	}
+
+	if ((returnCode == MIC_RC_SUCCESS) && (CGRAMSelected == CLEAR))
+	{
+		returnCode = _writeInstruction(MIC_LCD_INST_SETDDRAMADDR + (DDRAMAddr & MIC_LCD_INST_SETDDRAMADDR_ADDRMASK));
+	}
+
+	return returnCode;
+}
+
+// Function: MIC_RC attachSnapshot (MIC_LCD_SNAPSHOT *snapshot)
+MIC_RC MIC_LCD::attachSnapshot(MIC_LCD_SNAPSHOT *snapshot)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+
+	_LCD_Attributes._snapshot = snapshot;
+
+	if (snapshot != NULL)
+	{
+		snapshot->magic = 0;
+		snapshot->row = _LCD_Attributes._row;
+		snapshot->column = _LCD_Attributes._column;
+		snapshot->entryModeSet = *((BYTE*)&_LCD_Attributes._entryModeSet);
+		snapshot->displayONOFF = *((BYTE*)&_LCD_Attributes._displayONOFF);
+		snapshot->functionSet = *((BYTE*)&_LCD_Attributes._functionSet);
+		snapshot->AC = _LCD_Attributes._AC;
+		snapshot->CGRAMSelected = _LCD_Attributes._CGRAMSelected;
+
+		if (_LCD_Attributes._writeOnly == SET)
+		{
+			memset(snapshot->DDRAM, 0x20, MIC_LCD_DDRAMSIZE);
+			memset(snapshot->CGRAM, 0x00, MIC_LCD_CGRAMSIZE);
+		}
+		else
+		{
+			returnCode = readSnapshot(snapshot);
+		}
+	}
+
+	return returnCode;
+}
+
+// Function: MIC_RC readSnapshot (MIC_LCD_SNAPSHOT *snapshot)
+// RAM is read with increment entry mode, entry mode and AC are restored afterward.
+MIC_RC MIC_LCD::readSnapshot(MIC_LCD_SNAPSHOT *snapshot)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	ENTRYMODESET entryModeSet = _LCD_Attributes._entryModeSet;
+	BYTE AC = _LCD_Attributes._AC;
+	BYTE CGRAMSelected = _LCD_Attributes._CGRAMSelected;
+	BYTE counter = 0;
+
+	if ((_LCD_Attributes._writeOnly == SET) || (snapshot == NULL))
+	{
+		return MIC_RC_LCD_ERROR;
+	}
+
+	_LCD_Attributes._entryModeSet._ShiftDisplay = CLEAR;
+	_LCD_Attributes._entryModeSet._shiftRight = SET;
+	returnCode = _writeInstruction(*((BYTE*)&_LCD_Attributes._entryModeSet));
+
+	if (returnCode == MIC_RC_SUCCESS)
+	{
+		returnCode = _writeInstruction(MIC_LCD_INST_SETDDRAMADDR);
+	}
+
+	for (counter = 0; (counter < MIC_LCD_DDRAMSIZE) && (returnCode == MIC_RC_SUCCESS); counter++)
+	{
+		if ((counter == (MIC_LCD_DDRAMSIZE / 2)) && (_LCD_Attributes._functionSet._2LineMode == SET))
+		{
+			returnCode = _writeInstruction(MIC_LCD_INST_SETDDRAMADDR + 0x40);
+		}
+
+		if (returnCode == MIC_RC_SUCCESS)
+		{
+			returnCode = _readData(&snapshot->DDRAM[counter]);
+		}
+	}
+
+	if (returnCode == MIC_RC_SUCCESS)
+	{
+		returnCode = _writeInstruction(MIC_LCD_INST_SETCGRAMADDR);
+	}
+
+	for (counter = 0; (counter < MIC_LCD_CGRAMSIZE) && (returnCode == MIC_RC_SUCCESS); counter++)
+	{
+		returnCode = _readData(&snapshot->CGRAM[counter]);
+	}
+
+	_LCD_Attributes._entryModeSet = entryModeSet;
+
+	if (returnCode == MIC_RC_SUCCESS)
+	{
+		returnCode = _writeInstruction(*((BYTE*)&_LCD_Attributes._entryModeSet));
+	}
+
+	if (returnCode == MIC_RC_SUCCESS)
+	{
+		returnCode = _writeInstruction((CGRAMSelected == SET) ?
+			(MIC_LCD_INST_SETCGRAMADDR + (AC & MIC_LCD_INST_SETCGRAMADDR_ADDRMASK)) :
+			(MIC_LCD_INST_SETDDRAMADDR + (AC & MIC_LCD_INST_SETDDRAMADDR_ADDRMASK)));
+	}
+
+	return returnCode;
+}
+
+// Function: MIC_RC recover (void)
+// Snapshot is detached while recovering, so PORST (clear display) does not wipe it.
+// DDRAM is cleared to space by PORST, only non-space runs are written.
+MIC_RC MIC_LCD::recover(void)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	MIC_LCD_SNAPSHOT *snapshot = _LCD_Attributes._snapshot;
+	FUNCTIONSET functionSet;
+	BYTE counter = 0;
+	BYTE address = 0;
+
+	if ((snapshot == NULL) || (snapshot->row == 0) || (snapshot->column == 0))
+	{
+		return MIC_RC_LCD_ERROR;
+	}
+
+	_LCD_Attributes._snapshot = NULL;
+
+	*((BYTE*)&_LCD_Attributes._displayONOFF) = snapshot->displayONOFF;
+	*((BYTE*)&functionSet) = snapshot->functionSet;
+
+	returnCode = PORST(snapshot->row, snapshot->column);
+
+	// Line mode and font could be changed after PORST
+	if ((returnCode == MIC_RC_SUCCESS) &&
+	((functionSet._2LineMode != _LCD_Attributes._functionSet._2LineMode) ||
+	(functionSet._5x11Format != _LCD_Attributes._functionSet._5x11Format)))
+	{
+		_LCD_Attributes._functionSet._2LineMode = functionSet._2LineMode;
+		_LCD_Attributes._functionSet._5x11Format = functionSet._5x11Format;
+		returnCode = _writeInstruction(*((BYTE*)&_LCD_Attributes._functionSet));
+	}
+
+	// PORST restores the cached entry mode, CGRAM and DDRAM are written with increment and without display shift
+	if (returnCode == MIC_RC_SUCCESS)
+	{
+		_LCD_Attributes._entryModeSet._ShiftDisplay = CLEAR;
+		_LCD_Attributes._entryModeSet._shiftRight = SET;
+		returnCode = _writeInstruction(*((BYTE*)&_LCD_Attributes._entryModeSet));
+	}
+
+	if (returnCode == MIC_RC_SUCCESS)
+	{
+		returnCode = _writeInstruction(MIC_LCD_INST_SETCGRAMADDR);
+	}
+
+	for (counter = 0; (counter < MIC_LCD_CGRAMSIZE) && (returnCode == MIC_RC_SUCCESS); counter++)
+	{
+		returnCode = _writeData(snapshot->CGRAM[counter]);
+	}
+
+	for (counter = 0; (counter < MIC_LCD_DDRAMSIZE) && (returnCode == MIC_RC_SUCCESS); counter++)
+	{
+		if (snapshot->DDRAM[counter] == 0x20)
+		{
+			continue;
+		}
+
+		if ((_LCD_Attributes._functionSet._2LineMode == SET) && (counter >= (MIC_LCD_DDRAMSIZE / 2)))
+		{
+			address = 0x40 + counter - (MIC_LCD_DDRAMSIZE / 2);
+		}
+		else
+		{
+			address = counter;
+		}
+
+		if ((_LCD_Attributes._ACValid == CLEAR) || (_LCD_Attributes._CGRAMSelected == SET) ||
+		(_LCD_Attributes._AC != address))
+		{
+			returnCode = _writeInstruction(MIC_LCD_INST_SETDDRAMADDR + address);
+		}
+
+		if (returnCode == MIC_RC_SUCCESS)
+		{
+			returnCode = _writeData(snapshot->DDRAM[counter]);
+		}
+	}
+
+	if (returnCode == MIC_RC_SUCCESS)
+	{
+		*((BYTE*)&_LCD_Attributes._entryModeSet) = snapshot->entryModeSet;
+		returnCode = _writeInstruction(*((BYTE*)&_LCD_Attributes._entryModeSet));
+	}
+
+	if (returnCode == MIC_RC_SUCCESS)
+	{
+		returnCode = _writeInstruction((snapshot->CGRAMSelected == SET) ?
+			(MIC_LCD_INST_SETCGRAMADDR + (snapshot->AC & MIC_LCD_INST_SETCGRAMADDR_ADDRMASK)) :
+			(MIC_LCD_INST_SETDDRAMADDR + (snapshot->AC & MIC_LCD_INST_SETDDRAMADDR_ADDRMASK)));
+	}
+
+	_LCD_Attributes._snapshot = snapshot;
+
+	return returnCode;
+}
+
+// Function: MIC_RC saveSnapshot (int address)
+// On ESP boards, EEPROM.begin() should be called by application.
+MIC_RC MIC_LCD::saveSnapshot(int address)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	MIC_LCD_SNAPSHOT *snapshot = _LCD_Attributes._snapshot;
+
+	if (snapshot == NULL)
+	{
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+	else
+	{
+#ifdef MIC_LCD_EEPROM
+		snapshot->magic = MIC_LCD_SNAPSHOTMAGIC;
+		snapshot->checksum = _snapshotChecksum(snapshot);
+
+		EEPROM.put(address, *snapshot);
+#if defined(ESP8266) || defined(ESP32)
+		if (!EEPROM.commit())
+		{
+			returnCode = MIC_RC_LCD_ERROR;
+		}
+#endif
+#else
+		(void)address;
+		returnCode = MIC_RC_LCD_ERROR;
+#endif
+	}
+
+	return returnCode;
+}
+
+// Function: MIC_RC loadSnapshot (int address)
+// Attached snapshot is overwritten, its content is not valid if error is returned.
+MIC_RC MIC_LCD::loadSnapshot(int address)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	MIC_LCD_SNAPSHOT *snapshot = _LCD_Attributes._snapshot;
+
+	if (snapshot == NULL)
+	{
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+	else
+	{
+#ifdef MIC_LCD_EEPROM
+		EEPROM.get(address, *snapshot);
+
+		if ((snapshot->magic != MIC_LCD_SNAPSHOTMAGIC) || (snapshot->checksum != _snapshotChecksum(snapshot)))
+		{
+			snapshot->magic = 0;
+			returnCode = MIC_RC_LCD_ERROR;
+		}
+#else
+		(void)address;
+		returnCode = MIC_RC_LCD_ERROR;
+#endif
+	}
+
+	return returnCode;
+}
+
+// Function: void setBusyTimeout (UINT16 timeout)
+void MIC_LCD::setBusyTimeout(UINT16 timeout)
+{
+	_LCD_Attributes._busyTimeout = timeout;
+
+	return;
+}
+
+// Function: void setProbeInterval (UINT16 interval)
+void MIC_LCD::setProbeInterval(UINT16 interval)
+{
+	_LCD_Attributes._probeInterval = interval;
+
+	return;
+}
+
+// Function: MIC_RC checkHealth (void)
+// Failed LCD is probed with one status read per probe interval. When busy flag reads clear, LCD is initialized again
+// by recover (snapshot attached) or PORST.
+MIC_RC MIC_LCD::checkHealth(void)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	MIC_LCD_STATUS status = {0, SET};
+
+	if (_LCD_Attributes._health.state == MIC_LCD_HEALTH_OK)
+	{
+		return returnCode;
+	}
+
+	if ((millis() - _LCD_Attributes._lastProbe) < _LCD_Attributes._probeInterval)
+	{
+		return MIC_RC_LCD_ERROR;
+	}
+	_LCD_Attributes._lastProbe = millis();
+
+	status = _readStatus();
+
+	if (status.busy == SET)
+	{
+		_LCD_Attributes._health.failedProbeCount++;
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+	else
+	{
+		if (_LCD_Attributes._snapshot != NULL)
+		{
+			returnCode = recover();
+		}
+		else
+		{
+			returnCode = PORST(_LCD_Attributes._row, _LCD_Attributes._column);
+		}
+
+		if (returnCode == MIC_RC_SUCCESS)
+		{
+			_LCD_Attributes._health.recoveryCount++;
+		}
+		else
+		{
+			_LCD_Attributes._health.state = MIC_LCD_HEALTH_FAILED;
+		}
+	}
+
+	return returnCode;
+}
+
+// Function: void getHealth (MIC_LCD_HEALTH *health)
+void MIC_LCD::getHealth(MIC_LCD_HEALTH *health)
+{
+	*health = _LCD_Attributes._health;
+
+	return;
+}
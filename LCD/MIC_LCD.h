@@ -1,6 +1,39 @@
 #ifndef MIC_LCD_h
 #define MIC_LCD_h
 
+// LCD layout support, up to 4 rows and 40 columns within the 80 characters of DDRAM (e.g. 16x4, 20x4, 40x2)
+// Line buffers of the screen helpers are sized from the geometry at runtime, not from these limits.
+#define MIC_LCD_MAXCOLUMN		40
+#define MIC_LCD_MAXROW			4
+#define MIC_LCD_MAXCELLS		80		// DDRAM size, a geometry can not have more cells than this
+
+// Display geometry: DDRAM address of every screen cell is derived from it
+// Standard modules put row 1 - 4 at 0x00, 0x40, 0x00 + columns, 0x40 + columns.
+// Some 1 row modules (16x1 type 1) are wired as 2 rows of 8: columns from splitColumn on continue at rowOffset + 0x40.
+typedef struct
+{
+	BYTE rows;
+	BYTE columns;
+	BYTE rowOffset[MIC_LCD_MAXROW];	// DDRAM address of column 1 of each row
+	BYTE splitColumn;				// 0 = row is contiguous in DDRAM, otherwise first split column (starts from 0)
+} MIC_LCD_GEOMETRY;
+
+// Built-in geometry profiles
+extern const MIC_LCD_GEOMETRY MIC_LCD_GEOMETRY_8X1;
+extern const MIC_LCD_GEOMETRY MIC_LCD_GEOMETRY_8X2;
+extern const MIC_LCD_GEOMETRY MIC_LCD_GEOMETRY_16X1;
+extern const MIC_LCD_GEOMETRY MIC_LCD_GEOMETRY_16X1_SPLIT;
+extern const MIC_LCD_GEOMETRY MIC_LCD_GEOMETRY_16X2;
+extern const MIC_LCD_GEOMETRY MIC_LCD_GEOMETRY_16X4;
+extern const MIC_LCD_GEOMETRY MIC_LCD_GEOMETRY_20X2;
+extern const MIC_LCD_GEOMETRY MIC_LCD_GEOMETRY_20X4;
+extern const MIC_LCD_GEOMETRY MIC_LCD_GEOMETRY_24X2;
+extern const MIC_LCD_GEOMETRY MIC_LCD_GEOMETRY_40X2;
+
+// CGRAM, 8 user defined characters (character code 0x00 - 0x07) in 5x8 dots format
+#define MIC_LCD_CGRAMSLOTS		8
+#define MIC_LCD_CGRAMGLYPHSIZE	8		// one byte per dot row, lower 5 bits are used
+
 // Instruction format: Entry Mode Set
 typedef struct
 {
@@ -37,6 +70,45 @@ typedef struct
 	BYTE _instruction : 3; // bit (7-5), instruction for function set (0b001)
 } FUNCTIONSET;
 
+// LCD RAM and register snapshot
+// DDRAM: 2-line mode, line 1 (0x00 - 0x27) at 0 - 39 and line 2 (0x40 - 0x67) at 40 - 79; 1-line mode, 0x00 - 0x4F at 0 - 79
+#define MIC_LCD_DDRAMSIZE		80
+#define MIC_LCD_CGRAMSIZE		(MIC_LCD_CGRAMSLOTS * MIC_LCD_CGRAMGLYPHSIZE)
+#define MIC_LCD_SNAPSHOTMAGIC	0x4C43
+
+typedef struct
+{
+	UINT16 magic;			// MIC_LCD_SNAPSHOTMAGIC when saved to EEPROM
+	BYTE row;
+	BYTE column;
+	BYTE entryModeSet;
+	BYTE displayONOFF;
+	BYTE functionSet;
+	BYTE AC;
+	BYTE CGRAMSelected;
+	BYTE DDRAM[MIC_LCD_DDRAMSIZE];
+	BYTE CGRAM[MIC_LCD_CGRAMSIZE];
+	BYTE checksum;			// EEPROM only, all bytes above add up with checksum to 0
+} MIC_LCD_SNAPSHOT;
+
+// LCD health
+// OK: LCD answers in time. FAILED: busy flag timed out, calls fail immediately until LCD is probed and initialized
+// again by checkHealth. RECOVERING: PORST in progress.
+#define MIC_LCD_HEALTH_OK			0
+#define MIC_LCD_HEALTH_FAILED		1
+#define MIC_LCD_HEALTH_RECOVERING	2
+
+#define MIC_LCD_BUSYTIMEOUT			4000	// us, longest instruction (clear display, return home) is 2.16ms at fosc 190kHz
+#define MIC_LCD_PROBEINTERVAL		500		// ms between probes of a failed LCD
+
+typedef struct
+{
+	BYTE state;
+	UINT16 timeoutCount;		// busy flag time outs
+	UINT16 recoveryCount;		// successful initializations by checkHealth
+	UINT16 failedProbeCount;	// probes with LCD still busy
+} MIC_LCD_HEALTH;
+
 // Status register format
 typedef struct
 {
@@ -50,11 +122,26 @@ public:
 	// LCD setup
 	// If LCD is configured as 4 bit bus mode, DB3-DB0 should be set to 0xff.
 	// This program does not perform boundary check for PIN number assignment.
+	// If R/#W is tied to GND, RW should be set to 0xff. The busy flag can not be read and
+	// instruction execution time is waited instead (write only mode).
+	// Geometry is optional, see setGeometry.
 	MIC_LCD(BYTE RS, BYTE EN, BYTE RW,
-			BYTE DB7, BYTE DB6, BYTE DB5, BYTE DB4, BYTE DB3, BYTE DB2, BYTE DB1, BYTE DB0);
+			BYTE DB7, BYTE DB6, BYTE DB5, BYTE DB4, BYTE DB3, BYTE DB2, BYTE DB1, BYTE DB0,
+			const MIC_LCD_GEOMETRY *geometry = NULL);
+
+	// LCD setup through a 74HC595 shift register on the hardware SPI port
+	// MOSI -> SER, SCK -> SRCLK, LATCH -> RCLK. R/#W of the LCD must be tied to GND.
+	// Shift register outputs: Q1 = RS, Q2 = EN, Q3 = DB4, Q4 = DB5, Q5 = DB6, Q6 = DB7, Q7 = backlight
+	// Bus mode is always 4 bit and write only.
+	MIC_LCD(BYTE LATCH, const MIC_LCD_GEOMETRY *geometry = NULL);
 
-	// Currently, this program supports 1, 2, 3 and 4 lines mode (3 and 4 lines modes have not been tested yet)
-	// This program does not perform row and column boundary test
+	// Use a built-in profile or a custom geometry, call before PORST. Geometry is validated and the cell address map
+	// is built here, so PORST, setCursor and display functions only look addresses up.
+	// If no geometry is set, PORST uses the standard layout for its rows and columns.
+	MIC_RC setGeometry(const MIC_LCD_GEOMETRY *geometry);
+
+	// Rows and columns are checked against the geometry (1 - 4 rows, up to 40 columns and 80 cells).
+	// Return error before any instruction is written when they differ from the geometry set by setGeometry.
 	// All PIN modes are set to output after PORST
 	// default functions are set as:
 	// Entry Mode: Cursor shift left
@@ -92,11 +179,60 @@ public:
 	MIC_RC displayShiftLEFT(void);
 	MIC_RC displayShiftRIGHT(void);
 
-	MIC_RC setCursor(BYTE row, BYTE column); // Input: row number and column number (all starts from 1)
+	// Input: row number and column number (all starts from 1)
+	// Cell address comes from the geometry map, no instruction is written when the cursor is already there.
+	MIC_RC setCursor(BYTE row, BYTE column);
 	MIC_RC displayStr(BYTE row, BYTE column, CHAR8 *string, BYTE strLen);
 	MIC_RC displayNum(BYTE row, BYTE column, INT32 number);
 	MIC_RC displayTime(BYTE row, BYTE column, BYTE hr, BYTE min, BYTE sec);
 
+	// Write one character at cursor, cursor moves by entry mode
+	MIC_RC putChar(BYTE character);
+
+	// Show a string, only characters different from shadow are written. Shadow is updated with written characters.
+	// Shadow holds strLen characters already shown from the same location.
+	MIC_RC displayDiff(BYTE row, BYTE column, CHAR8 *string, CHAR8 *shadow, BYTE strLen);
+
+	// Show a whole screen, getRow() * getColumn() characters row by row, against a shadow of what LCD shows.
+	// Screen helpers keep such a shadow. While *shadowValid is CLEAR, LCD content is unknown (e.g. after clearDisplay
+	// or PORST) and every cell is written, otherwise only cells different from shadow. *shadowValid is SET only
+	// after the whole screen has been written. Return error before PORST.
+	MIC_RC displayFrame(CHAR8 *frame, CHAR8 *shadow, BYTE *shadowValid);
+
+	// Write a user defined character into CGRAM slot (0 - 7), glyph has MIC_LCD_CGRAMGLYPHSIZE bytes.
+	// Everything on screen showing the slot changes with it. Cursor location is kept.
+	MIC_RC createChar(BYTE slot, BYTE *glyph);
+
+	// Snapshot of LCD state, used to recover LCD after a glitch or brownout
+	// Once attached, every instruction and data written is mirrored into the snapshot. If the bus can be read,
+	// current LCD content is read into the snapshot, otherwise LCD is expected to be cleared.
+	// Snapshot is owned by application, set to NULL to detach.
+	MIC_RC attachSnapshot(MIC_LCD_SNAPSHOT *snapshot);
+
+	// Read DDRAM and CGRAM back through the bus into snapshot (not available in write only mode)
+	MIC_RC readSnapshot(MIC_LCD_SNAPSHOT *snapshot);
+
+	// Re-run PORST with the geometry in the attached snapshot and restore CGRAM, DDRAM, modes and cursor in one burst.
+	// Display shift made by displayShiftLEFT/RIGHT is not restored.
+	MIC_RC recover(void);
+
+	// Persist the attached snapshot to EEPROM at address, or load it back (e.g. for a warm display at boot with recover).
+	// Return error if EEPROM is not available on the board or the saved snapshot is not valid.
+	MIC_RC saveSnapshot(int address);
+	MIC_RC loadSnapshot(int address);
+
+	// Busy flag time out (us) and probe interval (ms) of a failed LCD
+	void setBusyTimeout(UINT16 timeout);
+	void setProbeInterval(UINT16 interval);
+
+	// Call from main loop. If LCD is failed, probe it once per probe interval and initialize it again when it answers.
+	// Return MIC_RC_SUCCESS when LCD is OK.
+	MIC_RC checkHealth(void);
+	void getHealth(MIC_LCD_HEALTH *health);
+
+	BYTE getRow(void);		// number of rows set by PORST
+	BYTE getColumn(void);	// number of columns set by PORST
+
 private:
 	// Variables
 	struct
@@ -105,18 +241,64 @@ private:
 		BYTE _EN_PIN;
 		BYTE _RW_PIN;
 		BYTE _DB_PIN[8];
+		BYTE _LATCH_PIN;
+
+		BYTE _busMode;			// parallel pins or 74HC595 over SPI
+		BYTE _writeOnly;		// SET = busy flag can not be read, execution time is waited
+		BYTE _shiftRegister;	// 74HC595 outputs other than EN and DB (RS, backlight)
+		UINT16 _execTime;		// write only mode: execution time (us) of the last instruction/data
+		unsigned long _lastWrite;	// write only mode: micros() when the last instruction/data was written
 
 		BYTE _column;
 		BYTE _row;
+		MIC_LCD_GEOMETRY _geometry;
+		BYTE _geometrySet;				// SET = geometry given by application
+		BYTE _cellAddr[MIC_LCD_MAXCELLS];	// DDRAM address of each cell, row by row
 
 		ENTRYMODESET _entryModeSet;
 		DISPLAYONOFF _displayONOFF;
 		CURSORDISPLAYSHIFT _cursorDisplayShift;
 		FUNCTIONSET _functionSet;
 
+		BYTE _AC;				// address counter followed by instruction and data access
+		BYTE _CGRAMSelected;	// SET = AC is a CGRAM address, CLEAR = DDRAM address
+		BYTE _ACValid;			// SET = AC is known, set by an address instruction, clear display or return home
+
+		MIC_LCD_SNAPSHOT *_snapshot;	// NULL = no snapshot attached
+
+		UINT16 _busyTimeout;			// us
+		UINT16 _probeInterval;			// ms
+		unsigned long _lastProbe;		// millis() of the last time out or probe
+		MIC_LCD_HEALTH _health;
+
 	} _LCD_Attributes;
 
 	// Private functions
+	// Function: void _initAttributes(void)
+	// Default instruction attributes shared by all bus modes
+	void _initAttributes(const MIC_LCD_GEOMETRY *geometry);
+
+	// Function: MIC_RC _buildCellMap(const MIC_LCD_GEOMETRY *geometry)
+	// Validate geometry and fill cell address map, map is kept if geometry is not valid
+	MIC_RC _buildCellMap(const MIC_LCD_GEOMETRY *geometry);
+
+	// Function: MIC_RC _setCell(BYTE cell)
+	// Move AC to a cell (row * columns + column, starts from 0) without boundary check.
+	// Set address instruction is skipped when AC is known and already points to the cell.
+	MIC_RC _setCell(BYTE cell);
+
+	// Function: void _setRS(BYTE rs)
+	// Set RS signal. For 74HC595, RS is latched out only when it changes to keep address set-up time.
+	void _setRS(BYTE rs);
+
+	// Function: void _shiftBits(BYTE bitsWritten)
+	// 74HC595 only: higher 4 bits are latched out twice back to back, with EN high and EN low.
+	void _shiftBits(BYTE bitsWritten);
+
+	// Function: void _latch(BYTE value)
+	// 74HC595 only: shift one byte through SPI and latch it to the outputs.
+	void _latch(BYTE value);
+
 	// Function: BYTE _readBits(void)
 	// For 4 bits bus mode, DB7 - 4 are read to higher 4 bits;
 	// For 8 bits bus mode, all bits are read out.
@@ -136,6 +318,17 @@ private:
 	MIC_LCD_STATUS _readStatus(void);
 	MIC_RC _LCDReady(void);
 
+	// Function: void _mirror(BYTE rs, BYTE value)
+	// Mirror an instruction or data write into the attached snapshot, called before AC is updated
+	void _mirror(BYTE rs, BYTE value);
+
+	// Function: BYTE _snapshotChecksum(MIC_LCD_SNAPSHOT *snapshot)
+	BYTE _snapshotChecksum(MIC_LCD_SNAPSHOT *snapshot);
+
+	// Function: void _trackAC(BYTE rs, BYTE value)
+	// Follow address counter changes made by an instruction or a data read/write
+	void _trackAC(BYTE rs, BYTE value);
+
 	MIC_RC _writeInstruction(BYTE instruction);
 	MIC_RC _readData(BYTE *data);
 	MIC_RC _writeData(BYTE data);
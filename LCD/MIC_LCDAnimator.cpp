@@ -0,0 +1,178 @@
+#include "Arduino.h"
+
+#include "MIC_GeneralDef.h"
+#include "MIC_LCD.h"
+#include "MIC_LCDAnimator.h"
+
+// Private functions
+// Function: BYTE _mostOverdue(unsigned long now)
+// Return slot of the most overdue animation, MIC_LCD_CGRAMSLOTS if no frame is due
+// A pending first frame is always the most overdue.
+BYTE MIC_LCDAnimator::_mostOverdue(unsigned long now)
+{
+	BYTE counter = 0;
+	BYTE overdue = MIC_LCD_CGRAMSLOTS;
+	unsigned long late = 0;
+	unsigned long maxLate = 0;
+	MIC_LCD_ANIMATION *animation = NULL;
+
+	for (counter = 0; counter < MIC_LCD_CGRAMSLOTS; counter++)
+	{
+		animation = &_animation[counter];
+
+		if (animation->running == CLEAR)
+		{
+			continue;
+		}
+
+		if (animation->uploadPending == SET)
+		{
+			late = 0xffffffff;
+		}
+		else if ((now - animation->lastFrame) >= animation->interval)
+		{
+			late = (now - animation->lastFrame) - animation->interval;
+		}
+		else
+		{
+			continue;
+		}
+
+		if ((overdue == MIC_LCD_CGRAMSLOTS) || (late > maxLate))
+		{
+			overdue = counter;
+			maxLate = late;
+		}
+	}
+
+	return overdue;
+}
+
+// Function: MIC_RC _upload(BYTE slot)
+// Copy current frame from flash and write it into CGRAM
+MIC_RC MIC_LCDAnimator::_upload(BYTE slot)
+{
+	BYTE glyph[MIC_LCD_CGRAMGLYPHSIZE];
+	BYTE counter = 0;
+	const BYTE *frame = NULL;
+
+	frame = _animation[slot].frames + ((UINT16)_animation[slot].frame * MIC_LCD_CGRAMGLYPHSIZE);
+
+	for (counter = 0; counter < MIC_LCD_CGRAMGLYPHSIZE; counter++)
+	{
+		glyph[counter] = pgm_read_byte(frame + counter);
+	}
+
+	return _lcd->createChar(slot, glyph);
+}
+
+// Public functions
+// Function: MIC_LCDAnimator (MIC_LCD *lcd)
+MIC_LCDAnimator::MIC_LCDAnimator(MIC_LCD *lcd)
+{
+	BYTE counter = 0;
+
+	_lcd = lcd;
+	_skippedFrames = 0;
+
+	for (counter = 0; counter < MIC_LCD_CGRAMSLOTS; counter++)
+	{
+		_animation[counter].running = CLEAR;
+		_animation[counter].uploadPending = CLEAR;
+	}
+
+	return;
+}
+
+// Function: MIC_RC play (BYTE slot, const BYTE *frames, BYTE frameCount, UINT16 interval)
+MIC_RC MIC_LCDAnimator::play(BYTE slot, const BYTE *frames, BYTE frameCount, UINT16 interval)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	MIC_LCD_ANIMATION *animation = NULL;
+
+	if ((slot >= MIC_LCD_CGRAMSLOTS) || (frames == NULL) || (frameCount == 0) || (interval == 0))
+	{
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+	else
+	{
+		animation = &_animation[slot];
+
+		animation->frames = frames;
+		animation->frameCount = frameCount;
+		animation->frame = 0;
+		animation->interval = interval;
+		animation->lastFrame = millis();
+		animation->uploadPending = SET;
+		animation->running = SET;
+	}
+
+	return returnCode;
+}
+
+// Function: MIC_RC stop (BYTE slot)
+MIC_RC MIC_LCDAnimator::stop(BYTE slot)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+
+	if (slot >= MIC_LCD_CGRAMSLOTS)
+	{
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+	else
+	{
+		_animation[slot].running = CLEAR;
+		_animation[slot].uploadPending = CLEAR;
+	}
+
+	return returnCode;
+}
+
+// Function: MIC_RC tick (UINT16 budget)
+MIC_RC MIC_LCDAnimator::tick(UINT16 budget)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	MIC_LCD_ANIMATION *animation = NULL;
+	unsigned long now = 0;
+	unsigned long steps = 0;
+	UINT16 written = 0;
+	BYTE slot = 0;
+
+	now = millis();
+
+	slot = _mostOverdue(now);
+	while ((slot < MIC_LCD_CGRAMSLOTS) && (returnCode == MIC_RC_SUCCESS))
+	{
+		// First frame is always uploaded, a budget smaller than one frame would never show anything
+		if ((budget != 0) && (written != 0) && ((written + MIC_LCD_ANIM_BYTESPERFRAME) > budget))
+		{
+			break;
+		}
+
+		animation = &_animation[slot];
+
+		if (animation->uploadPending == CLEAR)
+		{
+			// Advance by the number of intervals passed, late frames are skipped
+			steps = (now - animation->lastFrame) / animation->interval;
+			_skippedFrames += (UINT16)(steps - 1);
+
+			animation->frame = (BYTE)((animation->frame + steps) % animation->frameCount);
+			animation->lastFrame += steps * animation->interval;
+		}
+
+		returnCode = _upload(slot);
+		animation->uploadPending = (returnCode == MIC_RC_SUCCESS) ? CLEAR : SET;
+		written += MIC_LCD_ANIM_BYTESPERFRAME;
+
+		slot = _mostOverdue(now);
+	}
+
+	return returnCode;
+}
+
+// Function: UINT16 getSkippedFrames (void)
+UINT16 MIC_LCDAnimator::getSkippedFrames(void)
+{
+	return _skippedFrames;
+}
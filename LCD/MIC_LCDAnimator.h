@@ -0,0 +1,52 @@
+#ifndef MIC_LCDAnimator_h
+#define MIC_LCDAnimator_h
+
+// CGRAM glyph animation
+// A multi-frame glyph sequence stored in flash (PROGMEM) is played into one CGRAM slot.
+// Every character on screen using the slot follows the animation, each frame costs one CGRAM upload and no DDRAM write.
+// Each CGRAM slot can run its own animation with its own frame interval.
+#define MIC_LCD_ANIM_BYTESPERFRAME	(MIC_LCD_CGRAMGLYPHSIZE + 2)	// set CGRAM address, glyph, restore DDRAM address
+
+typedef struct
+{
+	const BYTE *frames;			// PROGMEM, frameCount * MIC_LCD_CGRAMGLYPHSIZE bytes
+	BYTE frameCount;
+	BYTE frame;					// frame shown in CGRAM
+	UINT16 interval;			// ms per frame
+	unsigned long lastFrame;	// millis() at which the shown frame was due
+	BYTE running;				// SET = animation is playing
+	BYTE uploadPending;			// SET = current frame has not been written to CGRAM
+} MIC_LCD_ANIMATION;
+
+class MIC_LCDAnimator
+{
+public:
+	MIC_LCDAnimator(MIC_LCD *lcd);
+
+	// Play frames in a CGRAM slot (0 - 7). First frame is uploaded on next tick.
+	MIC_RC play(BYTE slot, const BYTE *frames, BYTE frameCount, UINT16 interval);
+
+	// Stop animation, the current frame stays in CGRAM
+	MIC_RC stop(BYTE slot);
+
+	// Upload frames which are due, most overdue first. Frames missed while late are skipped to keep the timing.
+	// budget: maximum bytes written to LCD in this tick (MIC_LCD_ANIM_BYTESPERFRAME per frame), 0 = no limit.
+	// The most overdue frame is uploaded even when it is bigger than the whole budget, otherwise it would never be shown.
+	// Never blocks for more than the frames being uploaded.
+	MIC_RC tick(UINT16 budget);
+
+	UINT16 getSkippedFrames(void);		// frames skipped because tick was late or over budget
+
+private:
+	MIC_LCD *_lcd;
+	MIC_LCD_ANIMATION _animation[MIC_LCD_CGRAMSLOTS];
+	UINT16 _skippedFrames;
+
+	// Function: BYTE _mostOverdue(unsigned long now)
+	// Return slot of the most overdue animation, MIC_LCD_CGRAMSLOTS if no frame is due
+	BYTE _mostOverdue(unsigned long now);
+
+	MIC_RC _upload(BYTE slot);
+};
+
+#endif
@@ -0,0 +1,375 @@
+#include "Arduino.h"
+
+#include "MIC_GeneralDef.h"
+#include "MIC_LCD.h"
+#include "MIC_LCDBigNum.h"
+
+// Character codes besides CGRAM glyphs
+#define _BLANK					0x20
+#define _FULLBLOCK				0xff
+#define _MIDDLEDOT				0xa5	// ROM code A00
+#define _GLYPH_BLANK			0xfe	// table code for blank cell
+
+// 2-row font glyphs (CGRAM slot)
+#define _LT						0		// left top corner
+#define _UB						1		// upper bar
+#define _RT						2		// right top corner
+#define _LL						3		// left lower corner
+#define _LB						4		// lower bar
+#define _LR						5		// right lower corner
+#define _UMB					6		// upper and middle bar
+#define _LMB					7		// middle and lower bar
+#define _FB						_FULLBLOCK
+#define _NO						_GLYPH_BLANK
+
+const BYTE _font2Glyph[8 * MIC_LCD_CGRAMGLYPHSIZE] PROGMEM =
+{
+	0x07, 0x0f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f,		// _LT
+	0x1f, 0x1f, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00,		// _UB
+	0x1c, 0x1e, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f,		// _RT
+	0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x0f, 0x07,		// _LL
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0x1f, 0x1f,		// _LB
+	0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1e, 0x1c,		// _LR
+	0x1f, 0x1f, 0x1f, 0x00, 0x00, 0x00, 0x1f, 0x1f,		// _UMB
+	0x1f, 0x00, 0x00, 0x00, 0x00, 0x1f, 0x1f, 0x1f		// _LMB
+};
+
+// 2-row font: top row 3 cells, bottom row 3 cells for '0' - '9', '-' and ' '
+const BYTE _font2Digit[12][2][MIC_LCD_BIGNUM_DIGITWIDTH] PROGMEM =
+{
+	{{_LT,  _UB,  _RT }, {_LL,  _LB,  _LR }},		// 0
+	{{_UB,  _RT,  _NO }, {_LB,  _FB,  _LB }},		// 1
+	{{_UMB, _UMB, _RT }, {_LL,  _LMB, _LMB}},		// 2
+	{{_UMB, _UMB, _RT }, {_LMB, _LMB, _LR }},		// 3
+	{{_LL,  _LB,  _FB }, {_NO,  _NO,  _FB }},		// 4
+	{{_FB,  _UMB, _UMB}, {_LMB, _LMB, _LR }},		// 5
+	{{_LT,  _UMB, _UMB}, {_LL,  _LMB, _LR }},		// 6
+	{{_UB,  _UB,  _RT }, {_NO,  _NO,  _FB }},		// 7
+	{{_LT,  _UMB, _RT }, {_LL,  _LMB, _LR }},		// 8
+	{{_LT,  _UMB, _RT }, {_LMB, _LMB, _LR }},		// 9
+	{{_LB,  _LB,  _LB }, {_NO,  _NO,  _NO }},		// -
+	{{_NO,  _NO,  _NO }, {_NO,  _NO,  _NO }}		// space
+};
+
+// 4-row font glyphs (CGRAM slot), digits are drawn as 7 segments
+#define _4UB					0		// upper bar
+#define _4LB					1		// lower bar
+
+const BYTE _font4Glyph[2 * MIC_LCD_CGRAMGLYPHSIZE] PROGMEM =
+{
+	0x1f, 0x1f, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00,		// _4UB
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0x1f, 0x1f		// _4LB
+};
+
+// Segments: a = top, b = top right, c = bottom right, d = bottom, e = bottom left, f = top left, g = middle
+#define _SEG_A					0x01
+#define _SEG_B					0x02
+#define _SEG_C					0x04
+#define _SEG_D					0x08
+#define _SEG_E					0x10
+#define _SEG_F					0x20
+#define _SEG_G					0x40
+
+// '0' - '9', '-' and ' '
+const BYTE _font4Segment[12] PROGMEM =
+{
+	0x3f, 0x06, 0x5b, 0x4f, 0x66, 0x6d, 0x7d, 0x07, 0x7f, 0x6f, 0x40, 0x00
+};
+
+// Private functions
+// Function: BYTE _cell(CHAR8 symbol, BYTE part, BYTE row)
+// Return character code drawing one cell of a symbol
+BYTE MIC_LCDBigNum::_cell(CHAR8 symbol, BYTE part, BYTE row)
+{
+	BYTE index = 0;
+	BYTE segment = 0;
+	BYTE vertical = 0;		// segment drawn as full block in this cell
+	BYTE bar = 0;			// segment drawn as a bar in this cell
+	BYTE code = _GLYPH_BLANK;
+
+	if (symbol == '.')
+	{
+		return (row == (_font - 1)) ? ((_font == MIC_LCD_BIGNUM_2ROW) ? _LB : _4LB) : _BLANK;
+	}
+
+	if (symbol == ':')
+	{
+		return ((_font == MIC_LCD_BIGNUM_2ROW) || (row == 1) || (row == 2)) ? _MIDDLEDOT : _BLANK;
+	}
+
+	index = (symbol == '-') ? 10 : ((symbol == ' ') ? 11 : (symbol - '0'));
+
+	if (_font == MIC_LCD_BIGNUM_2ROW)
+	{
+		code = pgm_read_byte(&_font2Digit[index][row][part]);
+	}
+	else
+	{
+		segment = pgm_read_byte(&_font4Segment[index]);
+
+		// Rows 0 - 1 are the upper half (f, b, a on top, g at the bottom), rows 2 - 3 the lower half (e, c, d at the bottom)
+		if (part != 1)
+		{
+			vertical = (row < 2) ? ((part == 0) ? _SEG_F : _SEG_B) : ((part == 0) ? _SEG_E : _SEG_C);
+		}
+		bar = (row == 0) ? _SEG_A : ((row == 1) ? _SEG_G : ((row == 3) ? _SEG_D : 0));
+
+		if ((segment & vertical) != 0)
+		{
+			code = _FULLBLOCK;
+		}
+		else if ((segment & bar) != 0)
+		{
+			code = (row == 0) ? _4UB : _4LB;
+		}
+	}
+
+	return (code == _GLYPH_BLANK) ? _BLANK : code;
+}
+
+// Function: MIC_RC _layout(CHAR8 *value, BYTE *symbolAt, BYTE *partAt)
+MIC_RC MIC_LCDBigNum::_layout(CHAR8 *value, BYTE *symbolAt, BYTE *partAt)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	BYTE counter = 0;
+	BYTE part = 0;
+	BYTE column = 0;
+	BYTE symbolWidth = 0;
+	BYTE wide = CLEAR;
+	BYTE previousWide = CLEAR;
+	BYTE total = 0;
+
+	// Total width first, for right alignment
+	for (counter = 0; value[counter] != 0; counter++)
+	{
+		wide = ((value[counter] == '.') || (value[counter] == ':')) ? CLEAR : SET;
+		total += (wide == SET) ? (MIC_LCD_BIGNUM_DIGITWIDTH + ((previousWide == SET) ? 1 : 0)) : 1;
+		previousWide = wide;
+
+		if (((value[counter] < '0') || (value[counter] > '9')) &&
+		(value[counter] != '-') && (value[counter] != ' ') && (value[counter] != '.') && (value[counter] != ':'))
+		{
+			returnCode = MIC_RC_LCD_ERROR;
+		}
+	}
+
+	if ((total > _width) || (counter > MIC_LCD_BIGNUM_MAXSYMBOLS))
+	{
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+
+	if (returnCode == MIC_RC_SUCCESS)
+	{
+		memset(symbolAt, MIC_LCD_BIGNUM_NOSYMBOL, _width);
+		memset(partAt, 0, _width);
+
+		column = _width - total;
+		previousWide = CLEAR;
+
+		for (counter = 0; value[counter] != 0; counter++)
+		{
+			wide = ((value[counter] == '.') || (value[counter] == ':')) ? CLEAR : SET;
+
+			if ((wide == SET) && (previousWide == SET))
+			{
+				column++;		// blank column between two wide symbols
+			}
+
+			symbolWidth = (wide == SET) ? MIC_LCD_BIGNUM_DIGITWIDTH : 1;
+			for (part = 0; part < symbolWidth; part++)
+			{
+				symbolAt[column] = counter;
+				partAt[column] = part;
+				column++;
+			}
+
+			previousWide = wide;
+		}
+	}
+
+	return returnCode;
+}
+
+// Public functions
+// Function: MIC_LCDBigNum (MIC_LCD *lcd)
+MIC_LCDBigNum::MIC_LCDBigNum(MIC_LCD *lcd)
+{
+	_lcd = lcd;
+	_font = MIC_LCD_BIGNUM_2ROW;
+	_row = 1;
+	_column = 1;
+	_width = 0;
+	_last[0] = 0;
+	_lastValid = CLEAR;
+
+	return;
+}
+
+// Function: MIC_RC begin (BYTE font, BYTE row, BYTE column, BYTE width)
+MIC_RC MIC_LCDBigNum::begin(BYTE font, BYTE row, BYTE column, BYTE width)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	BYTE glyph[MIC_LCD_CGRAMGLYPHSIZE];
+	const BYTE *glyphs = NULL;
+	BYTE glyphCount = 0;
+	BYTE slot = 0;
+	BYTE counter = 0;
+
+	if (((font != MIC_LCD_BIGNUM_2ROW) && (font != MIC_LCD_BIGNUM_4ROW)) || (row == 0) || (column == 0) || (width == 0) ||
+	((row + font - 1) > _lcd->getRow()) || ((column + width - 1) > _lcd->getColumn()))
+	{
+		return MIC_RC_LCD_ERROR;
+	}
+
+	_font = font;
+	_row = row;
+	_column = column;
+	_width = width;
+	_last[0] = 0;
+	_lastValid = CLEAR;
+
+	glyphs = (font == MIC_LCD_BIGNUM_2ROW) ? _font2Glyph : _font4Glyph;
+	glyphCount = (font == MIC_LCD_BIGNUM_2ROW) ? 8 : 2;
+
+	for (slot = 0; (slot < glyphCount) && (returnCode == MIC_RC_SUCCESS); slot++)
+	{
+		for (counter = 0; counter < MIC_LCD_CGRAMGLYPHSIZE; counter++)
+		{
+			glyph[counter] = pgm_read_byte(&glyphs[(slot * MIC_LCD_CGRAMGLYPHSIZE) + counter]);
+		}
+
+		returnCode = _lcd->createChar(slot, glyph);
+	}
+
+	return returnCode;
+}
+
+// Function: MIC_RC displayStr (CHAR8 *value)
+// Cells of the new value are compared with cells of the last value, only changed cells are written.
+MIC_RC MIC_LCDBigNum::displayStr(CHAR8 *value)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	BYTE newSymbol[MIC_LCD_MAXCOLUMN];
+	BYTE newPart[MIC_LCD_MAXCOLUMN];
+	BYTE oldSymbol[MIC_LCD_MAXCOLUMN];
+	BYTE oldPart[MIC_LCD_MAXCOLUMN];
+	BYTE row = 0;
+	BYTE column = 0;
+	BYTE newCell = 0;
+	BYTE oldCell = 0;
+
+	if (_width == 0)
+	{
+		return MIC_RC_LCD_ERROR;
+	}
+
+	returnCode = _layout(value, newSymbol, newPart);
+
+	if (returnCode == MIC_RC_SUCCESS)
+	{
+		returnCode = _layout(_last, oldSymbol, oldPart);
+	}
+
+	for (row = 0; (row < _font) && (returnCode == MIC_RC_SUCCESS); row++)
+	{
+		for (column = 0; (column < _width) && (returnCode == MIC_RC_SUCCESS); column++)
+		{
+			newCell = (newSymbol[column] == MIC_LCD_BIGNUM_NOSYMBOL) ? _BLANK : _cell(value[newSymbol[column]], newPart[column], row);
+			oldCell = (oldSymbol[column] == MIC_LCD_BIGNUM_NOSYMBOL) ? _BLANK : _cell(_last[oldSymbol[column]], oldPart[column], row);
+
+			if ((_lastValid == SET) && (newCell == oldCell))
+			{
+				continue;
+			}
+
+			// Set address instruction is skipped by LCD when AC already points to the cell
+			returnCode = _lcd->setCursor(_row + row, _column + column);
+
+			if (returnCode == MIC_RC_SUCCESS)
+			{
+				returnCode = _lcd->putChar(newCell);
+			}
+		}
+	}
+
+	if (returnCode == MIC_RC_SUCCESS)
+	{
+		strcpy(_last, value);
+		_lastValid = SET;
+	}
+	else
+	{
+		_lastValid = CLEAR;
+	}
+
+	return returnCode;
+}
+
+// Function: MIC_RC displayNum (INT32 number, BYTE decimals)
+MIC_RC MIC_LCDBigNum::displayNum(INT32 number, BYTE decimals)
+{
+	CHAR8 numStr[MIC_LCD_BIGNUM_MAXSYMBOLS + 2];
+	CHAR8 digits[12];
+	BYTE digitCount = 0;
+	BYTE position = 0;
+	BYTE counter = 0;
+	UINT32 magnitude = 0;
+
+	if (decimals > 9)
+	{
+		return MIC_RC_LCD_ERROR;
+	}
+
+	magnitude = (number < 0) ? (UINT32)(-(number + 1)) + 1 : (UINT32)number;
+
+	do
+	{
+		digits[digitCount++] = '0' + (magnitude % 10);
+		magnitude /= 10;
+	} while ((magnitude != 0) || (digitCount <= decimals));
+
+	if ((digitCount + 2) > MIC_LCD_BIGNUM_MAXSYMBOLS)
+	{
+		return MIC_RC_LCD_ERROR;
+	}
+
+	if (number < 0)
+	{
+		numStr[position++] = '-';
+	}
+
+	for (counter = digitCount; counter > 0; counter--)
+	{
+		if ((decimals != 0) && (counter == decimals))
+		{
+			numStr[position++] = '.';
+		}
+		numStr[position++] = digits[counter - 1];
+	}
+	numStr[position] = 0;
+
+	return displayStr(numStr);
+}
+
+// Function: MIC_RC displayTime (BYTE hr, BYTE min)
+MIC_RC MIC_LCDBigNum::displayTime(BYTE hr, BYTE min)
+{
+	CHAR8 timeStr[6];
+
+	if ((hr > 23) || (min > 59))
+	{
+		return MIC_RC_LCD_ERROR;
+	}
+
+	sprintf(timeStr, "%02d:%02d", hr, min);
+
+	return displayStr(timeStr);
+}
+
+// Function: void invalidate (void)
+void MIC_LCDBigNum::invalidate(void)
+{
+	_lastValid = CLEAR;
+
+	return;
+}
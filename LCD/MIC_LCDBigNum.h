@@ -0,0 +1,55 @@
+#ifndef MIC_LCDBigNum_h
+#define MIC_LCDBigNum_h
+
+// Big number renderer
+// Numbers are drawn 2 or 4 rows tall from segment glyphs loaded once into CGRAM.
+// Last value is remembered and only the cells that change are written, a clock or counter ticking once per second
+// costs a few bus bytes per changed digit instead of a full repaint.
+// Symbols: '0' - '9', '-' and ' ' are 3 columns wide with one blank column between two of them, '.' and ':' are 1 column.
+// Value is right aligned in the area given to begin.
+#define MIC_LCD_BIGNUM_2ROW			2		// uses CGRAM slots 0 - 7
+#define MIC_LCD_BIGNUM_4ROW			4		// uses CGRAM slots 0 - 1
+#define MIC_LCD_BIGNUM_MAXSYMBOLS	12
+#define MIC_LCD_BIGNUM_DIGITWIDTH	3
+#define MIC_LCD_BIGNUM_NOSYMBOL		0xff
+
+class MIC_LCDBigNum
+{
+public:
+	MIC_LCDBigNum(MIC_LCD *lcd);
+
+	// Load font glyphs into CGRAM and set the area (top left row and column from 1, width in columns)
+	MIC_RC begin(BYTE font, BYTE row, BYTE column, BYTE width);
+
+	// Show a value made of the symbols above
+	MIC_RC displayStr(CHAR8 *value);
+
+	// Show a number, decimals = digits after the decimal point
+	MIC_RC displayNum(INT32 number, BYTE decimals);
+
+	// Show hours and minutes as hh:mm
+	MIC_RC displayTime(BYTE hr, BYTE min);
+
+	// Write the whole area on next update, call begin again if CGRAM was lost as well
+	void invalidate(void);
+
+private:
+	MIC_LCD *_lcd;
+	BYTE _font;
+	BYTE _row;
+	BYTE _column;
+	BYTE _width;
+	CHAR8 _last[MIC_LCD_BIGNUM_MAXSYMBOLS + 1];	// value shown
+	BYTE _lastValid;							// CLEAR = area content is unknown
+
+	// Function: MIC_RC _layout(CHAR8 *value, BYTE *symbolAt, BYTE *partAt)
+	// Right align value in the area. For each area column, symbolAt is the symbol index (MIC_LCD_BIGNUM_NOSYMBOL for
+	// blank) and partAt the column inside the symbol.
+	MIC_RC _layout(CHAR8 *value, BYTE *symbolAt, BYTE *partAt);
+
+	// Function: BYTE _cell(CHAR8 symbol, BYTE part, BYTE row)
+	// Return character code drawing one cell of a symbol
+	BYTE _cell(CHAR8 symbol, BYTE part, BYTE row);
+};
+
+#endif
@@ -0,0 +1,191 @@
+#include "Arduino.h"
+
+#include "MIC_GeneralDef.h"
+#include "MIC_LCD.h"
+#include "MIC_LCDCompositor.h"
+
+// Private functions
+// Function: CHAR8 _compositeCell(BYTE row, BYTE column)
+// Return cell from the top most visible layer covering the location, space if no layer covers it
+CHAR8 MIC_LCDCompositor::_compositeCell(BYTE row, BYTE column)
+{
+	INT8 counter = 0;
+	MIC_LCD_LAYER *layer = NULL;
+	CHAR8 cell = 0x20;
+
+	for (counter = MIC_LCD_MAXLAYERS - 1; counter >= 0; counter--)
+	{
+		layer = &_layer[counter];
+
+		if ((layer->visible == SET) &&
+		(row >= layer->row) && (row < (layer->row + layer->rows)) &&
+		(column >= layer->column) && (column < (layer->column + layer->columns)))
+		{
+			cell = layer->cell[((row - layer->row) * layer->columns) + (column - layer->column)];
+			break;
+		}
+	}
+
+	return cell;
+}
+
+// Public functions
+// Function: MIC_LCDCompositor (MIC_LCD *lcd)
+MIC_LCDCompositor::MIC_LCDCompositor(MIC_LCD *lcd)
+{
+	BYTE counter = 0;
+
+	_lcd = lcd;
+
+	for (counter = 0; counter < MIC_LCD_MAXLAYERS; counter++)
+	{
+		_layer[counter].visible = CLEAR;
+	}
+
+	memset(_shown, 0, MIC_LCD_MAXCELLS);
+	_shownValid = CLEAR;
+	_changed = SET;
+
+	return;
+}
+
+// Function: MIC_RC openLayer (BYTE layer, BYTE row, BYTE column, BYTE rows, BYTE columns)
+MIC_RC MIC_LCDCompositor::openLayer(BYTE layer, BYTE row, BYTE column, BYTE rows, BYTE columns)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+
+	if ((layer >= MIC_LCD_MAXLAYERS) || (row == 0) || (column == 0) || (rows == 0) || (columns == 0) ||
+	((row + rows - 1) > _lcd->getRow()) || ((column + columns - 1) > _lcd->getColumn()))
+	{
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+	else
+	{
+		_layer[layer].row = row;
+		_layer[layer].column = column;
+		_layer[layer].rows = rows;
+		_layer[layer].columns = columns;
+		memset(_layer[layer].cell, 0x20, rows * columns);
+
+		_layer[layer].visible = SET;
+		_changed = SET;
+	}
+
+	return returnCode;
+}
+
+// Function: MIC_RC closeLayer (BYTE layer)
+MIC_RC MIC_LCDCompositor::closeLayer(BYTE layer)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+
+	if (layer >= MIC_LCD_MAXLAYERS)
+	{
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+	else if (_layer[layer].visible == SET)
+	{
+		_layer[layer].visible = CLEAR;
+		_changed = SET;
+	}
+
+	return returnCode;
+}
+
+// Function: MIC_RC layerStr (BYTE layer, BYTE row, BYTE column, CHAR8 *string, BYTE strLen)
+MIC_RC MIC_LCDCompositor::layerStr(BYTE layer, BYTE row, BYTE column, CHAR8 *string, BYTE strLen)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	MIC_LCD_LAYER *window = NULL;
+	CHAR8 *cell = NULL;
+
+	if ((layer >= MIC_LCD_MAXLAYERS) || (_layer[layer].visible == CLEAR))
+	{
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+	else
+	{
+		window = &_layer[layer];
+
+		if ((row == 0) || (column == 0) || (row > window->rows) || ((column + strLen - 1) > window->columns))
+		{
+			returnCode = MIC_RC_LCD_ERROR;
+		}
+	}
+
+	if (returnCode == MIC_RC_SUCCESS)
+	{
+		cell = &window->cell[((row - 1) * window->columns) + (column - 1)];
+
+		if (memcmp(cell, string, strLen) != 0)
+		{
+			memcpy(cell, string, strLen);
+			_changed = SET;
+		}
+	}
+
+	return returnCode;
+}
+
+// Function: MIC_RC layerClear (BYTE layer)
+MIC_RC MIC_LCDCompositor::layerClear(BYTE layer)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+
+	if ((layer >= MIC_LCD_MAXLAYERS) || (_layer[layer].visible == CLEAR))
+	{
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+	else
+	{
+		memset(_layer[layer].cell, 0x20, _layer[layer].rows * _layer[layer].columns);
+		_changed = SET;
+	}
+
+	return returnCode;
+}
+
+// Function: MIC_RC refresh (void)
+MIC_RC MIC_LCDCompositor::refresh(void)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	CHAR8 frame[MIC_LCD_MAXCELLS];
+	BYTE rows = 0;
+	BYTE columns = 0;
+	BYTE row = 0;
+	BYTE column = 0;
+
+	if (_changed == CLEAR)
+	{
+		return returnCode;
+	}
+
+	rows = _lcd->getRow();
+	columns = _lcd->getColumn();
+
+	for (row = 1; row <= rows; row++)
+	{
+		for (column = 1; column <= columns; column++)
+		{
+			frame[((row - 1) * columns) + (column - 1)] = _compositeCell(row, column);
+		}
+	}
+
+	returnCode = _lcd->displayFrame(frame, _shown, &_shownValid);
+
+	if (returnCode == MIC_RC_SUCCESS)
+	{
+		_changed = CLEAR;
+	}
+
+	return returnCode;
+}
+
+// Function: void invalidate (void)
+void MIC_LCDCompositor::invalidate(void)
+{
+	_shownValid = CLEAR;
+	_changed = SET;
+
+	return;
+}
@@ -0,0 +1,58 @@
+#ifndef MIC_LCDCompositor_h
+#define MIC_LCDCompositor_h
+
+// Layered windows
+// Each layer is a window with its own cell buffer. Layers are drawn in z order (higher layer on top),
+// cells outside of a window are transparent. Only cells whose composited value changed are written to LCD.
+#define MIC_LCD_MAXLAYERS			3
+#define MIC_LCD_LAYER_BASE			0
+#define MIC_LCD_LAYER_STATUS		1
+#define MIC_LCD_LAYER_POPUP			2
+
+typedef struct
+{
+	BYTE visible;		// SET = layer is open
+	BYTE row;			// window location on LCD, starts from 1
+	BYTE column;
+	BYTE rows;			// window size
+	BYTE columns;
+	CHAR8 cell[MIC_LCD_MAXCELLS];	// window content, (row - 1) * columns + (column - 1)
+} MIC_LCD_LAYER;
+
+class MIC_LCDCompositor
+{
+public:
+	MIC_LCDCompositor(MIC_LCD *lcd);
+
+	// Open a layer as a window, content is filled with space.
+	// Window must fit in the LCD size set by PORST.
+	MIC_RC openLayer(BYTE layer, BYTE row, BYTE column, BYTE rows, BYTE columns);
+
+	// Close a layer, the covered region is restored from the layers below on next refresh.
+	MIC_RC closeLayer(BYTE layer);
+
+	// Write a string into a layer, row and column are relative to the window (all starts from 1)
+	MIC_RC layerStr(BYTE layer, BYTE row, BYTE column, CHAR8 *string, BYTE strLen);
+
+	// Fill a layer with space
+	MIC_RC layerClear(BYTE layer);
+
+	// Composite all layers and write changed cells to LCD
+	MIC_RC refresh(void);
+
+	// Write all cells on next refresh (see MIC_LCD::displayFrame)
+	void invalidate(void);
+
+private:
+	MIC_LCD *_lcd;
+	MIC_LCD_LAYER _layer[MIC_LCD_MAXLAYERS];
+	CHAR8 _shown[MIC_LCD_MAXCELLS];		// composited cells on LCD, (row - 1) * LCD columns + (column - 1)
+	BYTE _shownValid;					// CLEAR = LCD content is unknown
+	BYTE _changed;						// SET = a layer changed after last refresh
+
+	// Function: CHAR8 _compositeCell(BYTE row, BYTE column)
+	// Return cell from the top most visible layer covering the location, space if no layer covers it
+	CHAR8 _compositeCell(BYTE row, BYTE column);
+};
+
+#endif
@@ -0,0 +1,204 @@
+#include "Arduino.h"
+
+#include "MIC_GeneralDef.h"
+#include "MIC_LCD.h"
+#include "MIC_LCDConsole.h"
+
+// Private functions
+// Function: void _layout(void)
+// Lay the ring buffer out for the LCD columns, history is cleared when they changed
+void MIC_LCDConsole::_layout(void)
+{
+	BYTE columns = _lcd->getColumn();
+	UINT16 lines = 0;
+
+	if (columns != _columns)
+	{
+		lines = (columns == 0) ? 0 : (_size / columns);
+		_columns = columns;
+		_lines = (lines > 0xff) ? 0xff : lines;
+		_head = 0;
+		_count = 0;
+		_scroll = 0;
+		_shownValid = CLEAR;
+	}
+
+	return;
+}
+
+// Function: BYTE _maxScroll(void)
+// Return how far the view can be scrolled back
+BYTE MIC_LCDConsole::_maxScroll(void)
+{
+	BYTE rows = _lcd->getRow();
+
+	return (_count > rows) ? (_count - rows) : 0;
+}
+
+// Function: MIC_RC _render(void)
+// Show the lines of the current view, only changed characters are written
+// Row 'rows' shows the line _scroll lines before the newest one, rows above show older lines or blank.
+MIC_RC MIC_LCDConsole::_render(void)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	CHAR8 frame[MIC_LCD_MAXCELLS];
+	BYTE rows = _lcd->getRow();
+	BYTE columns = _lcd->getColumn();
+	BYTE row = 0;
+	BYTE back = 0;			// lines before the newest line
+	BYTE slot = 0;
+
+	_layout();
+
+	for (row = 1; row <= rows; row++)
+	{
+		back = _scroll + (rows - row);
+
+		if (back < _count)
+		{
+			slot = (_head + _lines - 1 - back) % _lines;
+			memcpy(&frame[(row - 1) * columns], &_text[slot * columns], columns);
+		}
+		else
+		{
+			memset(&frame[(row - 1) * columns], 0x20, columns);
+		}
+	}
+
+	returnCode = _lcd->displayFrame(frame, _shown, &_shownValid);
+
+	return returnCode;
+}
+
+// Public functions
+// Function: MIC_LCDConsole (MIC_LCD *lcd, CHAR8 *text, UINT16 size)
+MIC_LCDConsole::MIC_LCDConsole(MIC_LCD *lcd, CHAR8 *text, UINT16 size)
+{
+	_lcd = lcd;
+	_text = text;
+	_size = (text == NULL) ? 0 : size;
+	_columns = 0;
+	_lines = 0;
+	_head = 0;
+	_count = 0;
+	_scroll = 0;
+	_stamp = CLEAR;
+	_shownValid = CLEAR;
+
+	return;
+}
+
+// Function: void timestamp (BYTE enable)
+void MIC_LCDConsole::timestamp(BYTE enable)
+{
+	_stamp = enable;
+
+	return;
+}
+
+// Function: MIC_RC print (CHAR8 *line)
+MIC_RC MIC_LCDConsole::print(CHAR8 *line)
+{
+	CHAR8 stamp[MIC_LCD_CONSOLE_STAMPLEN + 1];
+	CHAR8 *cells = NULL;
+	BYTE columns = 0;
+	BYTE column = 0;
+	unsigned long seconds = 0;
+
+	_layout();
+
+	if ((_columns == 0) || (_lines <= _lcd->getRow()))
+	{
+		return MIC_RC_LCD_ERROR;
+	}
+
+	columns = _columns;
+	cells = &_text[_head * columns];
+	memset(cells, 0x20, columns);
+
+	if (_stamp == SET)
+	{
+		seconds = millis() / 1000;
+		sprintf(stamp, "%02u:%02u ", (unsigned int)((seconds / 60) % 100), (unsigned int)(seconds % 60));
+
+		for (column = 0; (column < MIC_LCD_CONSOLE_STAMPLEN) && (column < columns); column++)
+		{
+			cells[column] = stamp[column];
+		}
+	}
+
+	while ((line != NULL) && (*line != 0) && (column < columns))
+	{
+		cells[column] = *line;
+		line++;
+		column++;
+	}
+
+	_head = (_head + 1) % _lines;
+	if (_count < _lines)
+	{
+		_count++;
+	}
+
+	// A scrolled back view keeps showing the same lines
+	if ((_scroll != 0) && (_scroll < _maxScroll()))
+	{
+		_scroll++;
+	}
+
+	return _render();
+}
+
+// Function: MIC_RC scrollUp (BYTE lines)
+MIC_RC MIC_LCDConsole::scrollUp(BYTE lines)
+{
+	_scroll = ((_scroll + lines) > _maxScroll()) ? _maxScroll() : (_scroll + lines);
+
+	return _render();
+}
+
+// Function: MIC_RC scrollDown (BYTE lines)
+MIC_RC MIC_LCDConsole::scrollDown(BYTE lines)
+{
+	_scroll = (lines > _scroll) ? 0 : (_scroll - lines);
+
+	return _render();
+}
+
+// Function: MIC_RC pageUp (void)
+MIC_RC MIC_LCDConsole::pageUp(void)
+{
+	return scrollUp(_lcd->getRow());
+}
+
+// Function: MIC_RC pageDown (void)
+MIC_RC MIC_LCDConsole::pageDown(void)
+{
+	return scrollDown(_lcd->getRow());
+}
+
+// Function: MIC_RC scrollEnd (void)
+MIC_RC MIC_LCDConsole::scrollEnd(void)
+{
+	_scroll = 0;
+
+	return _render();
+}
+
+// Function: MIC_RC clear (void)
+MIC_RC MIC_LCDConsole::clear(void)
+{
+	_head = 0;
+	_count = 0;
+	_scroll = 0;
+
+	return _render();
+}
+
+// Function: void invalidate (void)
+void MIC_LCDConsole::invalidate(void)
+{
+	_shownValid = CLEAR;
+
+	return;
+}
@@ -0,0 +1,63 @@
+#ifndef MIC_LCDConsole_h
+#define MIC_LCDConsole_h
+
+// Scrolling console
+// Lines are kept in a ring buffer owned by the caller, newest line at the bottom. History holds size / LCD columns
+// lines (at most 255), size it as history lines x columns, e.g. CHAR8 text[16 * 20] for 16 lines on a 20x4 LCD.
+// Screen is compared with what is shown, only characters that changed are written. No heap allocation.
+#define MIC_LCD_CONSOLE_STAMPLEN	6		// "mm:ss " prefix from millis()
+
+class MIC_LCDConsole
+{
+public:
+	// text: ring buffer of size characters, kept by the caller for the life of the console
+	MIC_LCDConsole(MIC_LCD *lcd, CHAR8 *text, UINT16 size);
+
+	// SET = prefix each new line with minutes and seconds since start ("mm:ss ")
+	void timestamp(BYTE enable);
+
+	// Append a line, cut to LCD columns. If the view is scrolled back it stays on the same lines.
+	// Return error before PORST, or when the buffer does not hold more lines than LCD rows.
+	// History is cleared when LCD columns change.
+	MIC_RC print(CHAR8 *line);
+
+	// Scroll back into history (up) or toward the newest line (down), by lines or by a page of LCD rows
+	MIC_RC scrollUp(BYTE lines);
+	MIC_RC scrollDown(BYTE lines);
+	MIC_RC pageUp(void);
+	MIC_RC pageDown(void);
+	MIC_RC scrollEnd(void);
+
+	// Remove all lines
+	MIC_RC clear(void);
+
+	// Write the whole screen on next update (see MIC_LCD::displayFrame)
+	void invalidate(void);
+
+private:
+	MIC_LCD *_lcd;
+	CHAR8 *_text;			// ring buffer of _lines lines of _columns characters, padded with space
+	UINT16 _size;
+	BYTE _columns;			// LCD columns the ring buffer is laid out for, 0 = not laid out yet
+	BYTE _lines;			// history lines
+	BYTE _head;				// slot for the next line
+	BYTE _count;			// lines in history
+	BYTE _scroll;			// lines scrolled back from the newest line
+	BYTE _stamp;
+	CHAR8 _shown[MIC_LCD_MAXCELLS];
+	BYTE _shownValid;
+
+	// Function: void _layout(void)
+	// Lay the ring buffer out for the LCD columns, history is cleared when they changed
+	void _layout(void);
+
+	// Function: BYTE _maxScroll(void)
+	// Return how far the view can be scrolled back
+	BYTE _maxScroll(void);
+
+	// Function: MIC_RC _render(void)
+	// Show the lines of the current view, only changed characters are written
+	MIC_RC _render(void);
+};
+
+#endif
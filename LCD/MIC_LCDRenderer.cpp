@@ -0,0 +1,264 @@
+#include "Arduino.h"
+
+#include "MIC_GeneralDef.h"
+#include "MIC_LCD.h"
+#include "MIC_LCDRenderer.h"
+
+#ifdef MIC_LCD_RENDERER
+
+#if !defined(ARDUINO)
+#include <chrono>
+#endif
+
+// Private functions
+// Function: void _publish(unsigned long startMicros)
+// Copy working frame to the back buffer and swap it in as the latest frame
+// The exchange hands the back buffer over and takes the previous middle buffer back, which the render task does not
+// own any more. Latency statistics have a single writer, so they need no read-modify-write.
+void MIC_LCDRenderer::_publish(unsigned long startMicros)
+{
+	BYTE previous = 0;
+	UINT32 latency = 0;
+
+	memcpy(_buffer[_back], _compose, MIC_LCD_MAXCELLS);
+
+	previous = _middle.exchange(_back | MIC_LCD_RENDER_NEWFRAME, std::memory_order_acq_rel);
+	_back = previous & MIC_LCD_RENDER_INDEXMASK;
+
+	if ((previous & MIC_LCD_RENDER_NEWFRAME) != 0)
+	{
+		_dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+	_submitted.fetch_add(1, std::memory_order_relaxed);
+
+	latency = (UINT32)(micros() - startMicros);
+	_lastSubmitLatency.store(latency, std::memory_order_relaxed);
+	if (latency > _maxSubmitLatency.load(std::memory_order_relaxed))
+	{
+		_maxSubmitLatency.store(latency, std::memory_order_relaxed);
+	}
+
+#if defined(ESP32)
+	if (_task != NULL)
+	{
+		xTaskNotifyGive(_task);
+	}
+#endif
+
+	return;
+}
+
+// Function: void _taskLoop(void)
+// Render task body, renders new frames until end() is called
+void MIC_LCDRenderer::_taskLoop(void)
+{
+	while (_running.load(std::memory_order_acquire))
+	{
+		if ((_middle.load(std::memory_order_acquire) & MIC_LCD_RENDER_NEWFRAME) != 0)
+		{
+			renderOnce();
+		}
+		else
+		{
+#if defined(ESP32)
+			ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(MIC_LCD_RENDER_IDLEWAIT));
+#else
+			std::this_thread::sleep_for(std::chrono::milliseconds(MIC_LCD_RENDER_IDLEWAIT));
+#endif
+		}
+	}
+
+	_stopped.store(true, std::memory_order_release);
+
+	return;
+}
+
+#if defined(ESP32)
+// Function: void _taskEntry(void *renderer)
+void MIC_LCDRenderer::_taskEntry(void *renderer)
+{
+	((MIC_LCDRenderer *)renderer)->_taskLoop();
+
+	vTaskDelete(NULL);
+}
+#endif
+
+// Public functions
+// Function: MIC_LCDRenderer (MIC_LCD *lcd)
+MIC_LCDRenderer::MIC_LCDRenderer(MIC_LCD *lcd)
+{
+	_lcd = lcd;
+	_rows = 0;
+	_columns = 0;
+
+	memset(_buffer, 0x20, sizeof(_buffer));
+	memset(_compose, 0x20, MIC_LCD_MAXCELLS);
+	_shownValid = CLEAR;
+
+	_middle.store(0);
+	_back = 1;
+	_front = 2;
+
+	_running.store(false);
+	_stopped.store(true);
+
+	_submitted.store(0);
+	_rendered.store(0);
+	_dropped.store(0);
+	_lastSubmitLatency.store(0);
+	_maxSubmitLatency.store(0);
+	_lastRenderTime.store(0);
+
+#if defined(ESP32)
+	_task = NULL;
+#endif
+
+	return;
+}
+
+// Function: ~MIC_LCDRenderer (void)
+MIC_LCDRenderer::~MIC_LCDRenderer(void)
+{
+	end();
+}
+
+// Function: MIC_RC attach (void)
+MIC_RC MIC_LCDRenderer::attach(void)
+{
+	if (_running.load())
+	{
+		return MIC_RC_LCD_ERROR;
+	}
+
+	_rows = _lcd->getRow();
+	_columns = _lcd->getColumn();
+	_shownValid = CLEAR;
+
+	return ((_rows == 0) || (_columns == 0)) ? MIC_RC_LCD_ERROR : MIC_RC_SUCCESS;
+}
+
+// Function: MIC_RC begin (BYTE core)
+MIC_RC MIC_LCDRenderer::begin(BYTE core)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+
+	if (attach() != MIC_RC_SUCCESS)
+	{
+		return MIC_RC_LCD_ERROR;
+	}
+
+	_stopped.store(false);
+	_running.store(true, std::memory_order_release);
+
+#if defined(ESP32)
+	if (xTaskCreatePinnedToCore(_taskEntry, "MIC_LCD", MIC_LCD_RENDER_STACKSIZE, this, MIC_LCD_RENDER_PRIORITY, &_task, core) != pdPASS)
+	{
+		_task = NULL;
+		_running.store(false);
+		_stopped.store(true);
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+#else
+	(void)core;
+	_thread = std::thread(&MIC_LCDRenderer::_taskLoop, this);
+#endif
+
+	return returnCode;
+}
+
+// Function: void end (void)
+void MIC_LCDRenderer::end(void)
+{
+	_running.store(false, std::memory_order_release);
+
+#if defined(ESP32)
+	if (_task != NULL)
+	{
+		xTaskNotifyGive(_task);
+
+		while (!_stopped.load(std::memory_order_acquire))
+		{
+			delay(1);
+		}
+		_task = NULL;
+	}
+#else
+	if (_thread.joinable())
+	{
+		_thread.join();
+	}
+#endif
+
+	return;
+}
+
+// Function: MIC_RC submitFrame (CHAR8 *frame)
+MIC_RC MIC_LCDRenderer::submitFrame(CHAR8 *frame)
+{
+	unsigned long startMicros = micros();
+
+	if ((_rows == 0) || (frame == NULL))
+	{
+		return MIC_RC_LCD_ERROR;
+	}
+
+	memcpy(_compose, frame, _rows * _columns);
+	_publish(startMicros);
+
+	return MIC_RC_SUCCESS;
+}
+
+// Function: MIC_RC submitField (BYTE row, BYTE column, CHAR8 *string, BYTE strLen)
+MIC_RC MIC_LCDRenderer::submitField(BYTE row, BYTE column, CHAR8 *string, BYTE strLen)
+{
+	unsigned long startMicros = micros();
+
+	if ((row == 0) || (column == 0) || (row > _rows) || ((column + strLen - 1) > _columns))
+	{
+		return MIC_RC_LCD_ERROR;
+	}
+
+	memcpy(&_compose[((row - 1) * _columns) + (column - 1)], string, strLen);
+	_publish(startMicros);
+
+	return MIC_RC_SUCCESS;
+}
+
+// Function: MIC_RC renderOnce (void)
+MIC_RC MIC_LCDRenderer::renderOnce(void)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	BYTE previous = 0;
+	unsigned long startMicros = 0;
+
+	if ((_middle.load(std::memory_order_acquire) & MIC_LCD_RENDER_NEWFRAME) == 0)
+	{
+		return returnCode;
+	}
+
+	previous = _middle.exchange(_front, std::memory_order_acq_rel);
+	_front = previous & MIC_LCD_RENDER_INDEXMASK;
+
+	startMicros = micros();
+	returnCode = _lcd->displayFrame(_buffer[_front], _shown, &_shownValid);
+
+	_lastRenderTime.store((UINT32)(micros() - startMicros), std::memory_order_relaxed);
+	_rendered.fetch_add(1, std::memory_order_relaxed);
+
+	return returnCode;
+}
+
+// Function: void getStats (MIC_LCD_RENDER_STATS *stats)
+void MIC_LCDRenderer::getStats(MIC_LCD_RENDER_STATS *stats)
+{
+	stats->submitted = _submitted.load(std::memory_order_relaxed);
+	stats->rendered = _rendered.load(std::memory_order_relaxed);
+	stats->dropped = _dropped.load(std::memory_order_relaxed);
+	stats->lastSubmitLatency = _lastSubmitLatency.load(std::memory_order_relaxed);
+	stats->maxSubmitLatency = _maxSubmitLatency.load(std::memory_order_relaxed);
+	stats->lastRenderTime = _lastRenderTime.load(std::memory_order_relaxed);
+
+	return;
+}
+
+#endif
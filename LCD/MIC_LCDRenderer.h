@@ -0,0 +1,114 @@
+#ifndef MIC_LCDRenderer_h
+#define MIC_LCDRenderer_h
+
+// Render task for multi-core targets
+// A render task owns the LCD bus, the application only hands frames over without waiting for the bus.
+// Handoff is a lock-free latest-frame-wins triple buffer: the producer owns the back buffer and publishes it with one
+// atomic exchange, the render task owns the front buffer. Neither side ever waits for the other. A frame replaced
+// before being rendered is dropped. There is one producer: submit calls should come from one thread at a time.
+// Backends: ESP32 FreeRTOS task pinned to a core, std::thread on host (non Arduino) builds.
+// After begin(), application should not call MIC_LCD directly, all output should go through the renderer.
+#if defined(ESP32) || !defined(ARDUINO)
+#define MIC_LCD_RENDERER
+
+#include <atomic>
+#if !defined(ARDUINO)
+#include <thread>
+#endif
+
+#define MIC_LCD_RENDER_IDLEWAIT		1		// ms the render task sleeps when there is no new frame
+#define MIC_LCD_RENDER_STACKSIZE	2048	// ESP32 task stack size
+#define MIC_LCD_RENDER_PRIORITY		1		// ESP32 task priority
+
+#define MIC_LCD_RENDER_NEWFRAME		0x80	// set in _middle when it holds a frame not rendered yet
+#define MIC_LCD_RENDER_INDEXMASK	0x03
+
+typedef struct
+{
+	UINT32 submitted;			// frames handed over by producers
+	UINT32 rendered;			// frames written to LCD
+	UINT32 dropped;				// frames replaced by a newer one before being rendered
+	UINT32 lastSubmitLatency;	// time spent in the last submit (us)
+	UINT32 maxSubmitLatency;	// longest time spent in a submit (us)
+	UINT32 lastRenderTime;		// bus time of the last rendered frame (us)
+} MIC_LCD_RENDER_STATS;
+
+class MIC_LCDRenderer
+{
+public:
+	MIC_LCDRenderer(MIC_LCD *lcd);
+
+	// Render task is stopped if it is still running
+	~MIC_LCDRenderer(void);
+
+	// Take the LCD size for frames. PORST should be done before. begin() calls it, without a render task it should
+	// be called before submit and renderOnce. Return error while the render task is running.
+	MIC_RC attach(void);
+
+	// Start the render task. PORST should be done before.
+	// core: ESP32 core the task is pinned to (normally 1, the core not running WiFi), ignored on host.
+	MIC_RC begin(BYTE core);
+
+	// Stop the render task and wait until it has finished the frame in progress
+	void end(void);
+
+	// Producer side, from one thread at a time (any thread)
+	// Hand over a whole frame, getRow() * getColumn() characters row by row.
+	MIC_RC submitFrame(CHAR8 *frame);
+
+	// Change a field of the latest frame and hand it over. Row and column start from 1.
+	MIC_RC submitField(BYTE row, BYTE column, CHAR8 *string, BYTE strLen);
+
+	// Render side: write the latest frame to LCD if there is a new one. Only changed cells are written.
+	// Called by the render task, can also be called directly after attach() when no task is started (single core
+	// targets, tests).
+	MIC_RC renderOnce(void);
+
+	void getStats(MIC_LCD_RENDER_STATS *stats);
+
+private:
+	MIC_LCD *_lcd;
+	BYTE _rows;
+	BYTE _columns;
+
+	CHAR8 _buffer[3][MIC_LCD_MAXCELLS];
+	CHAR8 _compose[MIC_LCD_MAXCELLS];	// producer side working frame, latest frame with field updates
+	CHAR8 _shown[MIC_LCD_MAXCELLS];		// render side, what is on LCD
+	BYTE _shownValid;
+
+	std::atomic<BYTE> _middle;			// buffer waiting to be rendered, with MIC_LCD_RENDER_NEWFRAME
+	BYTE _back;							// buffer owned by producer
+	BYTE _front;						// buffer owned by render task
+
+	std::atomic<bool> _running;
+	std::atomic<bool> _stopped;
+
+	std::atomic<UINT32> _submitted;
+	std::atomic<UINT32> _rendered;
+	std::atomic<UINT32> _dropped;
+	std::atomic<UINT32> _lastSubmitLatency;	// written by the producer only, read by getStats
+	std::atomic<UINT32> _maxSubmitLatency;
+	std::atomic<UINT32> _lastRenderTime;
+
+#if defined(ESP32)
+	TaskHandle_t _task;
+#else
+	std::thread _thread;
+#endif
+
+	// Function: void _publish(unsigned long startMicros)
+	// Copy working frame to the back buffer and swap it in as the latest frame
+	void _publish(unsigned long startMicros);
+
+	// Function: void _taskLoop(void)
+	// Render task body, renders new frames until end() is called
+	void _taskLoop(void);
+
+#if defined(ESP32)
+	static void _taskEntry(void *renderer);
+#endif
+};
+
+#endif
+
+#endif
@@ -0,0 +1,274 @@
+#include "Arduino.h"
+
+#include "MIC_GeneralDef.h"
+#include "MIC_LCD.h"
+#include "MIC_LCDScheduler.h"
+
+// Private functions
+// Function: BYTE _mostUrgent(unsigned long now)
+// Return most urgent dirty region, MIC_LCD_SCHED_MAXREGIONS if no region is dirty
+// Regions past their deadline (dirtySince + maxStale) go first, so a busy high priority region can not starve a
+// lower one forever. Within the overdue and the on time regions, lower priority value wins, then the earliest deadline.
+// A region past its deadline has its miss counted once per change.
+BYTE MIC_LCDScheduler::_mostUrgent(unsigned long now)
+{
+	BYTE counter = 0;
+	BYTE urgent = MIC_LCD_SCHED_MAXREGIONS;
+	long slack = 0;
+	long urgentSlack = 0;
+	BYTE overdue = CLEAR;
+	BYTE urgentOverdue = CLEAR;
+
+	for (counter = 0; counter < _regionCount; counter++)
+	{
+		if (_region[counter].dirty == SET)
+		{
+			// Time left before deadline, negative when deadline is already missed
+			slack = (long)_region[counter].maxStale - (long)(now - _region[counter].dirtySince);
+
+			overdue = (slack < 0) ? SET : CLEAR;
+
+			if ((overdue == SET) && (_region[counter].missCounted == CLEAR))
+			{
+				_region[counter].stats.deadlineMiss++;
+				_region[counter].missCounted = SET;
+			}
+
+			if ((urgent == MIC_LCD_SCHED_MAXREGIONS) ||
+			((overdue == SET) && (urgentOverdue == CLEAR)) ||
+			((overdue == urgentOverdue) && (_region[counter].priority < _region[urgent].priority)) ||
+			((overdue == urgentOverdue) && (_region[counter].priority == _region[urgent].priority) &&
+			(slack < urgentSlack)))
+			{
+				urgent = counter;
+				urgentSlack = slack;
+				urgentOverdue = overdue;
+			}
+		}
+	}
+
+	return urgent;
+}
+
+// Function: MIC_RC _flush(BYTE regionID)
+// Latency is measured to the end of the write
+MIC_RC MIC_LCDScheduler::_flush(BYTE regionID)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	MIC_LCD_REGION *region = &_region[regionID];
+	unsigned long startMicros = 0;
+	unsigned long elapsed = 0;
+	unsigned long latency = 0;
+
+	startMicros = micros();
+	returnCode = _lcd->displayStr(region->row, region->column, region->text, region->length);
+	elapsed = micros() - startMicros;
+
+	// Region is cleared even on error, a broken region should not block all others
+	region->dirty = CLEAR;
+
+	latency = millis() - region->dirtySince;
+	if ((latency > region->maxStale) && (region->missCounted == CLEAR))
+	{
+		region->stats.deadlineMiss++;
+		region->missCounted = SET;
+	}
+	if (latency > region->stats.maxLatency)
+	{
+		region->stats.maxLatency = (latency > 0xffff) ? 0xffff : (UINT16)latency;
+	}
+
+	region->stats.flushCount++;
+	region->stats.busTime += elapsed;
+
+	// One set cursor instruction plus one data write per character
+	if (returnCode == MIC_RC_SUCCESS)
+	{
+		_byteCost = (UINT16)((((UINT32)_byteCost * 3) + (elapsed / (region->length + 1))) / 4);
+	}
+
+	return returnCode;
+}
+
+// Public functions
+// Function: MIC_LCDScheduler (MIC_LCD *lcd)
+MIC_LCDScheduler::MIC_LCDScheduler (MIC_LCD *lcd)
+{
+	_lcd = lcd;
+	_regionCount = 0;
+	_textUsed = 0;
+	_byteCost = MIC_LCD_SCHED_BYTECOST;
+
+	return;
+}
+
+// Function: MIC_RC addRegion (BYTE row, BYTE column, BYTE length, BYTE priority, UINT16 maxStale, BYTE *regionID)
+MIC_RC MIC_LCDScheduler::addRegion (BYTE row, BYTE column, BYTE length, BYTE priority, UINT16 maxStale, BYTE *regionID)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	MIC_LCD_REGION *region = NULL;
+
+	if ((_regionCount >= MIC_LCD_SCHED_MAXREGIONS) || (row == 0) || (row > MIC_LCD_MAXROW) ||
+	(column == 0) || (length == 0) || ((column + length - 1) > MIC_LCD_MAXCOLUMN) ||
+	((_textUsed + length + 1) > MIC_LCD_SCHED_TEXTSIZE))
+	{
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+	else
+	{
+		region = &_region[_regionCount];
+
+		region->row = row;
+		region->column = column;
+		region->length = length;
+		region->priority = priority;
+		region->maxStale = maxStale;
+
+		region->text = &_text[_textUsed];
+		memset(region->text, 0x20, length);
+		region->text[length] = 0;
+		_textUsed += length + 1;
+
+		region->dirty = SET;
+		region->dirtySince = millis();
+		region->missCounted = CLEAR;
+		memset(&region->stats, 0, sizeof(MIC_LCD_REGION_STATS));
+
+		*regionID = _regionCount;
+		_regionCount++;
+	}
+
+	return returnCode;
+}
+
+// Function: MIC_RC updateRegion (BYTE regionID, CHAR8 *string)
+MIC_RC MIC_LCDScheduler::updateRegion (BYTE regionID, CHAR8 *string)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	MIC_LCD_REGION *region = NULL;
+	BYTE counter = 0;
+	CHAR8 character = 0x20;
+	BYTE changed = CLEAR;
+
+	if (regionID >= _regionCount)
+	{
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+	else
+	{
+		region = &_region[regionID];
+
+		for (counter = 0; counter < region->length; counter++)
+		{
+			if ((string != NULL) && (string[0] != 0))
+			{
+				character = *string;
+				string++;
+			}
+			else
+			{
+				character = 0x20;
+				string = NULL;
+			}
+
+			if (region->text[counter] != character)
+			{
+				region->text[counter] = character;
+				changed = SET;
+			}
+		}
+
+		// Staleness counts from the first change not yet written to LCD
+		if ((changed == SET) && (region->dirty == CLEAR))
+		{
+			region->dirty = SET;
+			region->dirtySince = millis();
+			region->missCounted = CLEAR;
+		}
+	}
+
+	return returnCode;
+}
+
+// Function: MIC_RC tick (UINT16 budget)
+MIC_RC MIC_LCDScheduler::tick (UINT16 budget)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	MIC_RC flushCode = MIC_RC_SUCCESS;
+	unsigned long now = 0;
+	unsigned long startMicros = 0;
+	unsigned long spent = 0;
+	UINT32 cost = 0;
+	BYTE urgent = 0;
+	BYTE flushed = CLEAR;
+
+	now = millis();
+	startMicros = micros();
+
+	urgent = _mostUrgent(now);
+	while (urgent < MIC_LCD_SCHED_MAXREGIONS)
+	{
+		cost = (UINT32)_byteCost * (_region[urgent].length + 1);
+		spent = micros() - startMicros;
+
+		if ((flushed == SET) && ((spent + cost) > budget))
+		{
+			break;
+		}
+
+		flushCode = _flush(urgent);
+		if (flushCode != MIC_RC_SUCCESS)
+		{
+			returnCode = flushCode;
+		}
+		flushed = SET;
+
+		urgent = _mostUrgent(now);
+	}
+
+	return returnCode;
+}
+
+// Function: MIC_RC regionStats (BYTE regionID, MIC_LCD_REGION_STATS *stats)
+MIC_RC MIC_LCDScheduler::regionStats (BYTE regionID, MIC_LCD_REGION_STATS *stats)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+
+	if (regionID >= _regionCount)
+	{
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+	else
+	{
+		*stats = _region[regionID].stats;
+	}
+
+	return returnCode;
+}
+
+// Function: UINT16 deadlineMisses (void)
+UINT16 MIC_LCDScheduler::deadlineMisses (void)
+{
+	BYTE counter = 0;
+	UINT16 misses = 0;
+
+	for (counter = 0; counter < _regionCount; counter++)
+	{
+		misses += _region[counter].stats.deadlineMiss;
+	}
+
+	return misses;
+}
+
+// Function: void resetStats (void)
+void MIC_LCDScheduler::resetStats (void)
+{
+	BYTE counter = 0;
+
+	for (counter = 0; counter < _regionCount; counter++)
+	{
+		memset(&_region[counter].stats, 0, sizeof(MIC_LCD_REGION_STATS));
+	}
+
+	return;
+}
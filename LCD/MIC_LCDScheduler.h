@@ -0,0 +1,76 @@
+#ifndef MIC_LCDScheduler_h
+#define MIC_LCDScheduler_h
+
+// Screen region scheduler
+// Application declares screen regions with priority and maximum staleness, and only updates region text.
+// Each main loop tick flushes the most urgent dirty regions first, within a bus time budget.
+#define MIC_LCD_SCHED_MAXREGIONS		8
+// Text of all regions shares one pool, each region takes length + 1 characters
+#define MIC_LCD_SCHED_TEXTSIZE			(MIC_LCD_MAXCELLS + MIC_LCD_SCHED_MAXREGIONS)
+#define MIC_LCD_SCHED_BYTECOST			60		// initial estimate of bus time per byte (us), adjusted by measurement
+
+// Region statistics
+typedef struct
+{
+	UINT16 flushCount;		// number of times the region was written to LCD
+	UINT16 deadlineMiss;	// number of changes not written within maximum staleness, also counted while still waiting
+	UINT32 busTime;			// total bus time spent on the region (us)
+	UINT16 maxLatency;		// longest time from first change to the end of its write (ms)
+} MIC_LCD_REGION_STATS;
+
+// Screen region
+typedef struct
+{
+	BYTE row;				// starts from 1
+	BYTE column;			// starts from 1
+	BYTE length;
+	BYTE priority;			// 0 = most urgent
+	UINT16 maxStale;		// region should be written to LCD within maxStale ms after it is changed
+	BYTE dirty;				// SET = text has not been written to LCD
+	unsigned long dirtySince;	// millis() of the first change not written to LCD
+	BYTE missCounted;		// SET = deadline miss of the current change is counted
+	CHAR8 *text;			// length characters in the text pool, terminated with 0
+	MIC_LCD_REGION_STATS stats;
+} MIC_LCD_REGION;
+
+class MIC_LCDScheduler
+{
+public:
+	MIC_LCDScheduler(MIC_LCD *lcd);
+
+	// Declare a region. All regions are filled with space and flushed on the first tick.
+	// Return error when the text of all regions does not fit in MIC_LCD_SCHED_TEXTSIZE.
+	// Output: regionID used by updateRegion and regionStats
+	MIC_RC addRegion(BYTE row, BYTE column, BYTE length, BYTE priority, UINT16 maxStale, BYTE *regionID);
+
+	// Copy string into region (cut or padded with space to region length). Region is marked dirty only if text changed.
+	MIC_RC updateRegion(BYTE regionID, CHAR8 *string);
+
+	// Flush dirty regions within budget (us) of bus time.
+	// Regions past their deadline are flushed first, then by priority and deadline, so a busy high priority region does
+	// not starve a lower one once its deadline has passed. Flushing stops at the first region not fitting in the
+	// remaining budget, so a less urgent region never overtakes a more urgent one. A region bigger than the whole
+	// budget is still flushed when it is the most urgent one, otherwise it would never be shown.
+	MIC_RC tick(UINT16 budget);
+
+	MIC_RC regionStats(BYTE regionID, MIC_LCD_REGION_STATS *stats);
+	UINT16 deadlineMisses(void);	// total of all regions
+	void resetStats(void);
+
+private:
+	MIC_LCD *_lcd;
+	MIC_LCD_REGION _region[MIC_LCD_SCHED_MAXREGIONS];
+	BYTE _regionCount;
+	CHAR8 _text[MIC_LCD_SCHED_TEXTSIZE];
+	BYTE _textUsed;
+	UINT16 _byteCost;		// measured bus time per byte (us)
+
+	// Function: BYTE _mostUrgent(unsigned long now)
+	// Return most urgent dirty region, MIC_LCD_SCHED_MAXREGIONS if no region is dirty.
+	// Deadline misses of waiting regions are counted here.
+	BYTE _mostUrgent(unsigned long now);
+
+	MIC_RC _flush(BYTE regionID);
+};
+
+#endif
@@ -0,0 +1,151 @@
+#include "Arduino.h"
+
+#include "MIC_GeneralDef.h"
+#include "MIC_LCD.h"
+#include "MIC_LCDScreenLib.h"
+
+// Private functions
+// Function: MIC_RC _open(MIC_LCD *lcd, UINT16 screenID)
+// Check screen fits in LCD and point decoder to the screen code stream
+MIC_RC MIC_LCDScreenDecoder::_open(MIC_LCD *lcd, UINT16 screenID)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+
+	if ((screenID >= _library->screenCount) ||
+	(_library->rows > lcd->getRow()) || (_library->columns > lcd->getColumn()))
+	{
+		returnCode = MIC_RC_LCD_ERROR;
+	}
+	else
+	{
+		_code = _library->screenData + pgm_read_word(&_library->screenIndex[screenID]);
+		_dict = NULL;
+		_dictLeft = 0;
+		_spacesLeft = 0;
+	}
+
+	return returnCode;
+}
+
+// Function: CHAR8 _next(void)
+// Return next character of the open screen
+CHAR8 MIC_LCDScreenDecoder::_next(void)
+{
+	BYTE code = 0;
+	UINT16 entry = 0;
+	UINT16 offset = 0;
+
+	if (_spacesLeft != 0)
+	{
+		_spacesLeft--;
+		return 0x20;
+	}
+
+	if (_dictLeft != 0)
+	{
+		_dictLeft--;
+		return (CHAR8)pgm_read_byte(_dict++);
+	}
+
+	code = pgm_read_byte(_code++);
+
+	if (code == MIC_LCD_SCREEN_ESCAPE)
+	{
+		return (CHAR8)pgm_read_byte(_code++);
+	}
+
+	switch (code & MIC_LCD_SCREEN_CODEMASK)
+	{
+	case MIC_LCD_SCREEN_SPACERUN:
+		_spacesLeft = code & MIC_LCD_SCREEN_VALUEMASK;
+		return 0x20;
+
+	case MIC_LCD_SCREEN_DICTIONARY:
+		entry = code & MIC_LCD_SCREEN_VALUEMASK;
+		offset = pgm_read_word(&_library->dictIndex[entry]);
+		_dict = _library->dictData + offset;
+		_dictLeft = (BYTE)(pgm_read_word(&_library->dictIndex[entry + 1]) - offset - 1);
+		return (CHAR8)pgm_read_byte(_dict++);
+
+	default:
+		return (CHAR8)code;
+	}
+}
+
+// Public functions
+// Function: MIC_LCDScreenDecoder (const MIC_LCD_SCREENLIB *library)
+MIC_LCDScreenDecoder::MIC_LCDScreenDecoder(const MIC_LCD_SCREENLIB *library)
+{
+	_library = library;
+	_code = NULL;
+	_dict = NULL;
+	_dictLeft = 0;
+	_spacesLeft = 0;
+
+	return;
+}
+
+// Function: MIC_RC displayScreen (MIC_LCD *lcd, UINT16 screenID)
+// Set address instruction is issued by LCD only at row start and where a row is split in DDRAM.
+MIC_RC MIC_LCDScreenDecoder::displayScreen(MIC_LCD *lcd, UINT16 screenID)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	BYTE row = 0;
+	BYTE column = 0;
+
+	returnCode = _open(lcd, screenID);
+
+	for (row = 1; (row <= _library->rows) && (returnCode == MIC_RC_SUCCESS); row++)
+	{
+		for (column = 1; (column <= _library->columns) && (returnCode == MIC_RC_SUCCESS); column++)
+		{
+			returnCode = lcd->setCursor(row, column);
+
+			if (returnCode == MIC_RC_SUCCESS)
+			{
+				returnCode = lcd->putChar(_next());
+			}
+		}
+	}
+
+	return returnCode;
+}
+
+// Function: MIC_RC displayScreenDiff (MIC_LCD *lcd, UINT16 screenID, CHAR8 *shown)
+// Only changed characters are written, set address instruction is skipped by LCD when AC already points to the cell.
+MIC_RC MIC_LCDScreenDecoder::displayScreenDiff(MIC_LCD *lcd, UINT16 screenID, CHAR8 *shown)
+{
+	MIC_RC returnCode = MIC_RC_SUCCESS;
+	BYTE row = 0;
+	BYTE column = 0;
+	CHAR8 character = 0;
+
+	returnCode = _open(lcd, screenID);
+
+	for (row = 1; (row <= _library->rows) && (returnCode == MIC_RC_SUCCESS); row++)
+	{
+		for (column = 1; (column <= _library->columns) && (returnCode == MIC_RC_SUCCESS); column++)
+		{
+			character = _next();
+
+			if (*shown != character)
+			{
+				returnCode = lcd->setCursor(row, column);
+
+				if (returnCode == MIC_RC_SUCCESS)
+				{
+					returnCode = lcd->putChar(character);
+				}
+
+				if (returnCode == MIC_RC_SUCCESS)
+				{
+					*shown = character;
+				}
+			}
+
+			shown++;
+		}
+	}
+
+	return returnCode;
+}
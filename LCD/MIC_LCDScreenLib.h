@@ -0,0 +1,59 @@
+#ifndef MIC_LCDScreenLib_h
+#define MIC_LCDScreenLib_h
+
+// Compressed screen library stored in flash
+// Screens are packed at build time by tools/MIC_LCDScreenCompiler into a generated header (all arrays in PROGMEM).
+// Each screen is a code stream of rows * columns characters, row by row:
+//  0x00			escape, next byte is a literal character (CGRAM 0x00 and ROM characters 0x80 - 0xFF)
+//  0x01 - 0x7F		literal character
+//  0x80 - 0xBF		run of (code & 0x3F) + 1 spaces
+//  0xC0 - 0xFF		dictionary entry (code & 0x3F), entries are literal characters only
+// Screen and dictionary offsets are kept in index tables, any screen is found by ID in O(1).
+#define MIC_LCD_SCREEN_ESCAPE		0x00
+#define MIC_LCD_SCREEN_SPACERUN		0x80
+#define MIC_LCD_SCREEN_DICTIONARY	0xC0
+#define MIC_LCD_SCREEN_CODEMASK		0xC0
+#define MIC_LCD_SCREEN_VALUEMASK	0x3F
+#define MIC_LCD_SCREEN_MAXRUN		64
+#define MIC_LCD_SCREEN_MAXDICTIONARY	64
+
+typedef struct
+{
+	BYTE rows;
+	BYTE columns;
+	UINT16 screenCount;
+	const UINT16 *screenIndex;	// PROGMEM, offset of each screen in screenData
+	const BYTE *screenData;		// PROGMEM
+	const UINT16 *dictIndex;	// PROGMEM, offset of each dictionary entry in dictData, one more entry for the end
+	const BYTE *dictData;		// PROGMEM
+} MIC_LCD_SCREENLIB;
+
+class MIC_LCDScreenDecoder
+{
+public:
+	MIC_LCDScreenDecoder(const MIC_LCD_SCREENLIB *library);
+
+	// Stream a screen to LCD, every character is written. Screen is shown from row 1, column 1.
+	MIC_RC displayScreen(MIC_LCD *lcd, UINT16 screenID);
+
+	// Stream a screen to LCD, only characters different from shown are written.
+	// shown: library rows * columns characters on LCD, updated with written characters
+	MIC_RC displayScreenDiff(MIC_LCD *lcd, UINT16 screenID, CHAR8 *shown);
+
+private:
+	const MIC_LCD_SCREENLIB *_library;
+
+	// Decoder state, a few bytes only
+	const BYTE *_code;		// next code in screenData
+	const BYTE *_dict;		// next character of the dictionary entry being copied
+	BYTE _dictLeft;			// characters left in dictionary entry
+	BYTE _spacesLeft;		// spaces left in run
+
+	MIC_RC _open(MIC_LCD *lcd, UINT16 screenID);
+
+	// Function: CHAR8 _next(void)
+	// Return next character of the open screen
+	CHAR8 _next(void);
+};
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef Arduino_h
+#define Arduino_h
+
+// Host stub of the Arduino core for simulation builds, pins, SPI and time are routed to MIC_LCDSim
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HIGH		1
+#define LOW			0
+#define INPUT		0
+#define OUTPUT		1
+#define MSBFIRST	1
+
+#define PROGMEM
+#define pgm_read_byte(address)	(*(const uint8_t *)(address))
+#define pgm_read_word(address)	(*(const uint16_t *)(address))
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+unsigned long millis(void);
+unsigned long micros(void);
+
+#endif
@@ -0,0 +1,566 @@
+#include "Arduino.h"
+#include <SPI.h>
+
+#include <chrono>
+#include <thread>
+
+#include "MIC_GeneralDef.h"
+#include "MIC_LCDSim.h"
+
+// 74HC595 outputs, wired as MIC_LCD(BYTE LATCH)
+#define MIC_LCDSIM_595_RS		0x02	// Q1
+#define MIC_LCDSIM_595_EN		0x04	// Q2
+#define MIC_LCDSIM_595_DBMASK	0x78	// Q6 - Q3 = DB7 - DB4
+#define MIC_LCDSIM_595_DBSHIFT	1
+
+// Defined before MIC_Sim, the model reads the clock when it is constructed
+static const std::chrono::steady_clock::time_point _startTime = std::chrono::steady_clock::now();
+
+MIC_LCDSim MIC_Sim;
+SPIClass SPI;
+
+// Host stubs
+void pinMode(uint8_t pin, uint8_t mode)
+{
+	(void)pin;
+	(void)mode;
+
+	return;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+	MIC_Sim.pinWrite(pin, value);
+
+	return;
+}
+
+int digitalRead(uint8_t pin)
+{
+	return MIC_Sim.pinRead(pin);
+}
+
+unsigned long micros(void)
+{
+	return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - _startTime).count();
+}
+
+unsigned long millis(void)
+{
+	return micros() / 1000;
+}
+
+void delay(unsigned long ms)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+
+	return;
+}
+
+// Busy wait, a sleep would be much longer than the delay
+void delayMicroseconds(unsigned int us)
+{
+	unsigned long start = micros();
+
+	while ((micros() - start) < us)
+	{
+	}
+
+	return;
+}
+
+void SPIClass::begin(void)
+{
+	return;
+}
+
+void SPIClass::beginTransaction(SPISettings settings)
+{
+	(void)settings;
+
+	return;
+}
+
+void SPIClass::endTransaction(void)
+{
+	return;
+}
+
+uint8_t SPIClass::transfer(uint8_t data)
+{
+	MIC_Sim.spiTransfer(data);
+
+	return 0;
+}
+
+// Private functions
+// Function: void _stepAC(BYTE increment)
+// DDRAM address wraps at the end of a line (0x27 -> 0x40, 0x67 -> 0x00 in 2-line mode, 0x4F -> 0x00 in 1-line mode)
+void MIC_LCDSim::_stepAC(BYTE increment)
+{
+	if (_CGRAMSelected == SET)
+	{
+		_AC = (_AC + ((increment == SET) ? 1 : -1)) & (MIC_LCDSIM_CGRAMSIZE - 1);
+	}
+	else if (_lines2 == SET)
+	{
+		if (increment == SET)
+		{
+			_AC = (_AC == 0x27) ? 0x40 : ((_AC == 0x67) ? 0x00 : (_AC + 1));
+		}
+		else
+		{
+			_AC = (_AC == 0x40) ? 0x27 : ((_AC == 0x00) ? 0x67 : (_AC - 1));
+		}
+	}
+	else
+	{
+		if (increment == SET)
+		{
+			_AC = (_AC == 0x4f) ? 0x00 : (_AC + 1);
+		}
+		else
+		{
+			_AC = (_AC == 0x00) ? 0x4f : (_AC - 1);
+		}
+	}
+
+	return;
+}
+
+// Function: BYTE _busy(void)
+BYTE MIC_LCDSim::_busy(void)
+{
+	return ((_stuckBusy == SET) || ((long)(micros() - _busyUntil) < 0)) ? SET : CLEAR;
+}
+
+// Function: void _readDone(BYTE rs)
+void MIC_LCDSim::_readDone(BYTE rs)
+{
+	if (_bus8Bit == CLEAR)
+	{
+		_nibblePending = (_nibblePending == SET) ? CLEAR : SET;
+		if (_nibblePending == SET)
+		{
+			return;
+		}
+	}
+
+	if (rs == HIGH)
+	{
+		if (_busy() == SET)
+		{
+			_stats.busyViolations++;
+		}
+
+		_stepAC(_increment);
+		_busyUntil = micros() + ((MIC_LCDSIM_EXECTIME_SHORT * MIC_LCDSIM_FOSC) / _fosc);
+	}
+
+	return;
+}
+
+// Function: void _execute(BYTE rs, BYTE value)
+void MIC_LCDSim::_execute(BYTE rs, BYTE value)
+{
+	unsigned long execTime = MIC_LCDSIM_EXECTIME_SHORT;
+
+	if (rs == HIGH)
+	{
+		if (_CGRAMSelected == SET)
+		{
+			_CGRAM[_AC] = value;
+		}
+		else
+		{
+			_DDRAM[_AC] = value;
+		}
+		_stepAC(_increment);
+		_stats.data++;
+	}
+	else
+	{
+		if ((value & 0x80) != 0)
+		{
+			// Set DDRAM address
+			_AC = value & 0x7f;
+			_CGRAMSelected = CLEAR;
+		}
+		else if ((value & 0x40) != 0)
+		{
+			// Set CGRAM address
+			_AC = value & 0x3f;
+			_CGRAMSelected = SET;
+		}
+		else if ((value & 0x20) != 0)
+		{
+			// Function set, a new interface width starts with the first nibble
+			_bus8Bit = ((value & 0x10) != 0) ? SET : CLEAR;
+			_lines2 = ((value & 0x08) != 0) ? SET : CLEAR;
+			_nibblePending = CLEAR;
+		}
+		else if ((value & 0x10) != 0)
+		{
+			// Cursor shift moves AC, display shift does not
+			if ((value & 0x08) == 0)
+			{
+				_stepAC(((value & 0x04) != 0) ? SET : CLEAR);
+			}
+		}
+		else if ((value & 0x08) != 0)
+		{
+			// Display ON/OFF control, display is not rendered
+		}
+		else if ((value & 0x04) != 0)
+		{
+			// Entry mode set, display shift is not rendered
+			_increment = ((value & 0x02) != 0) ? SET : CLEAR;
+		}
+		else if ((value & 0x02) != 0)
+		{
+			// Return home
+			_AC = 0;
+			_CGRAMSelected = CLEAR;
+			execTime = MIC_LCDSIM_EXECTIME_LONG;
+		}
+		else if ((value & 0x01) != 0)
+		{
+			// Clear display, entry mode is set to increment
+			memset(_DDRAM, 0x20, MIC_LCDSIM_DDRAMSIZE);
+			_AC = 0;
+			_CGRAMSelected = CLEAR;
+			_increment = SET;
+			execTime = MIC_LCDSIM_EXECTIME_LONG;
+		}
+		_stats.instructions++;
+	}
+
+	_busyUntil = micros() + ((execTime * MIC_LCDSIM_FOSC) / _fosc);
+
+	if (_hook != NULL)
+	{
+		_hook(rs, value);
+	}
+
+	return;
+}
+
+// Function: void _strobe(BYTE rs, BYTE bus)
+void MIC_LCDSim::_strobe(BYTE rs, BYTE bus)
+{
+	if (_busy() == SET)
+	{
+		_stats.busyViolations++;
+	}
+
+	if (_stuckBusy == SET)
+	{
+		return;
+	}
+
+	if (_bus8Bit == SET)
+	{
+		_execute(rs, bus);
+	}
+	else if (_nibblePending == CLEAR)
+	{
+		_highNibble = bus & 0xf0;
+		_nibblePending = SET;
+	}
+	else
+	{
+		_nibblePending = CLEAR;
+		_execute(rs, _highNibble | (bus >> 4));
+	}
+
+	return;
+}
+
+// Function: void _outputsChanged(BYTE previous)
+void MIC_LCDSim::_outputsChanged(BYTE previous)
+{
+	BYTE changed = previous ^ _outputs;
+
+	if ((changed & MIC_LCDSIM_595_EN) != 0)
+	{
+		// RS is set up before EN rising, RS and DB are held across EN falling. DB may change with EN rising.
+		if ((_outputs & MIC_LCDSIM_595_EN) != 0)
+		{
+			if ((changed & MIC_LCDSIM_595_RS) != 0)
+			{
+				_stats.timingViolations++;
+			}
+		}
+		else
+		{
+			if ((changed & (MIC_LCDSIM_595_RS | MIC_LCDSIM_595_DBMASK)) != 0)
+			{
+				_stats.timingViolations++;
+			}
+
+			_strobe(((_outputs & MIC_LCDSIM_595_RS) != 0) ? HIGH : LOW,
+				(_outputs & MIC_LCDSIM_595_DBMASK) << MIC_LCDSIM_595_DBSHIFT);
+		}
+	}
+	else if (((_outputs & MIC_LCDSIM_595_EN) != 0) && ((changed & MIC_LCDSIM_595_RS) != 0))
+	{
+		_stats.timingViolations++;
+	}
+
+	return;
+}
+
+// Public functions
+// Function: MIC_LCDSim (void)
+MIC_LCDSim::MIC_LCDSim(void)
+{
+	BYTE counter = 0;
+
+	_latchPin = 0xff;
+	_RS_PIN = 0xff;
+	_EN_PIN = 0xff;
+	_RW_PIN = 0xff;
+
+	for (counter = 0; counter < 8; counter++)
+	{
+		_DB_PIN[counter] = 0xff;
+	}
+
+	_fosc = MIC_LCDSIM_FOSC;
+	_stuckBusy = CLEAR;
+	_hook = NULL;
+	powerOn();
+
+	return;
+}
+
+// Function: void attach595 (BYTE LATCH)
+void MIC_LCDSim::attach595(BYTE LATCH)
+{
+	_latchPin = LATCH;
+	_RS_PIN = 0xff;
+	_EN_PIN = 0xff;
+	_RW_PIN = 0xff;
+
+	return;
+}
+
+// Function: void attachParallel (BYTE RS, BYTE EN, BYTE RW, BYTE DB7, BYTE DB6, BYTE DB5, BYTE DB4,
+//								BYTE DB3, BYTE DB2, BYTE DB1, BYTE DB0)
+void MIC_LCDSim::attachParallel(BYTE RS, BYTE EN, BYTE RW,
+		BYTE DB7, BYTE DB6, BYTE DB5, BYTE DB4, BYTE DB3, BYTE DB2, BYTE DB1, BYTE DB0)
+{
+	_latchPin = 0xff;
+	_RS_PIN = RS;
+	_EN_PIN = EN;
+	_RW_PIN = RW;
+
+	_DB_PIN[0] = DB0;
+	_DB_PIN[1] = DB1;
+	_DB_PIN[2] = DB2;
+	_DB_PIN[3] = DB3;
+	_DB_PIN[4] = DB4;
+	_DB_PIN[5] = DB5;
+	_DB_PIN[6] = DB6;
+	_DB_PIN[7] = DB7;
+
+	return;
+}
+
+// Function: void oscillator (UINT16 fosc)
+void MIC_LCDSim::oscillator(UINT16 fosc)
+{
+	_fosc = fosc;
+
+	return;
+}
+
+// Function: void powerOn (void)
+void MIC_LCDSim::powerOn(void)
+{
+	memset(_pin, LOW, sizeof(_pin));
+	_shiftRegister = 0;
+	_outputs = 0;
+
+	memset(_DDRAM, 0x20, MIC_LCDSIM_DDRAMSIZE);
+	memset(_CGRAM, 0x00, MIC_LCDSIM_CGRAMSIZE);
+	_AC = 0;
+	_CGRAMSelected = CLEAR;
+	_increment = SET;
+	_bus8Bit = SET;
+	_lines2 = CLEAR;
+	_highNibble = 0;
+	_nibblePending = CLEAR;
+
+	_busyUntil = micros() + MIC_LCDSIM_POWERONTIME;
+	memset(&_stats, 0, sizeof(_stats));
+
+	return;
+}
+
+// Function: void stuckBusy (BYTE stuck)
+void MIC_LCDSim::stuckBusy(BYTE stuck)
+{
+	_stuckBusy = stuck;
+
+	return;
+}
+
+// Function: void setHook (void (*hook)(BYTE rs, BYTE value))
+void MIC_LCDSim::setHook(void (*hook)(BYTE rs, BYTE value))
+{
+	_hook = hook;
+
+	return;
+}
+
+// Function: BYTE DDRAM (BYTE address)
+BYTE MIC_LCDSim::DDRAM(BYTE address)
+{
+	return _DDRAM[address & (MIC_LCDSIM_DDRAMSIZE - 1)];
+}
+
+// Function: BYTE CGRAM (BYTE address)
+BYTE MIC_LCDSim::CGRAM(BYTE address)
+{
+	return _CGRAM[address & (MIC_LCDSIM_CGRAMSIZE - 1)];
+}
+
+// Function: BYTE AC (void)
+BYTE MIC_LCDSim::AC(void)
+{
+	return _AC;
+}
+
+// Function: BYTE CGRAMSelected (void)
+BYTE MIC_LCDSim::CGRAMSelected(void)
+{
+	return _CGRAMSelected;
+}
+
+// Function: BYTE bus8Bit (void)
+BYTE MIC_LCDSim::bus8Bit(void)
+{
+	return _bus8Bit;
+}
+
+// Function: BYTE lines2 (void)
+BYTE MIC_LCDSim::lines2(void)
+{
+	return _lines2;
+}
+
+// Function: void text (BYTE address, BYTE length, CHAR8 *text)
+void MIC_LCDSim::text(BYTE address, BYTE length, CHAR8 *text)
+{
+	BYTE counter = 0;
+	BYTE character = 0;
+
+	for (counter = 0; counter < length; counter++)
+	{
+		character = DDRAM(address + counter);
+		text[counter] = (character < 0x08) ? ('0' + character) : character;
+	}
+	text[length] = 0;
+
+	return;
+}
+
+// Function: void getStats (MIC_LCDSIM_STATS *stats)
+void MIC_LCDSim::getStats(MIC_LCDSIM_STATS *stats)
+{
+	*stats = _stats;
+
+	return;
+}
+
+// Function: void pinWrite (BYTE pin, BYTE value)
+// Latch rising edge moves the 74HC595 shift register to its outputs. Parallel bus: RS should not change while
+// EN is high, LCD takes RS and DB on EN falling edge.
+void MIC_LCDSim::pinWrite(BYTE pin, BYTE value)
+{
+	BYTE previous = 0;
+	BYTE bus = 0;
+	BYTE counter = 0;
+
+	value = (value != LOW) ? HIGH : LOW;
+	previous = _pin[pin];
+	_pin[pin] = value;
+
+	if ((pin == _latchPin) && (previous == LOW) && (value == HIGH))
+	{
+		previous = _outputs;
+		_outputs = _shiftRegister;
+		_outputsChanged(previous);
+	}
+	else if ((pin == _RS_PIN) && (previous != value) && (_pin[_EN_PIN] == HIGH))
+	{
+		_stats.timingViolations++;
+	}
+	else if ((pin == _EN_PIN) && (previous == HIGH) && (value == LOW) && (_RW_PIN != 0xff) && (_pin[_RW_PIN] == HIGH))
+	{
+		_readDone(_pin[_RS_PIN]);
+	}
+	else if ((pin == _EN_PIN) && (previous == HIGH) && (value == LOW))
+	{
+		for (counter = 0; counter < 8; counter++)
+		{
+			if ((_DB_PIN[counter] != 0xff) && (_pin[_DB_PIN[counter]] == HIGH))
+			{
+				bus |= (1 << counter);
+			}
+		}
+
+		_strobe(_pin[_RS_PIN], bus);
+	}
+
+	return;
+}
+
+// Function: BYTE pinRead (BYTE pin)
+// LCD drives DB only while R/#W and EN are high: busy flag and AC with RS low, DDRAM or CGRAM at AC with RS high.
+// 4 bit interface: high nibble first, then low nibble, both on DB7 - DB4.
+BYTE MIC_LCDSim::pinRead(BYTE pin)
+{
+	BYTE value = 0;
+	BYTE counter = 0;
+
+	if ((_RW_PIN == 0xff) || (_pin[_RW_PIN] == LOW) || (_pin[_EN_PIN] == LOW))
+	{
+		return LOW;
+	}
+
+	if (_pin[_RS_PIN] == LOW)
+	{
+		value = ((_busy() == SET) ? 0x80 : 0x00) | (_AC & 0x7f);
+	}
+	else
+	{
+		value = (_CGRAMSelected == SET) ? _CGRAM[_AC] : _DDRAM[_AC];
+	}
+
+	if ((_bus8Bit == CLEAR) && (_nibblePending == SET))
+	{
+		value = value << 4;
+	}
+
+	for (counter = 0; counter < 8; counter++)
+	{
+		if (_DB_PIN[counter] == pin)
+		{
+			return ((value >> counter) & 0x01) ? HIGH : LOW;
+		}
+	}
+
+	return LOW;
+}
+
+// Function: void spiTransfer (BYTE value)
+void MIC_LCDSim::spiTransfer(BYTE value)
+{
+	_shiftRegister = value;
+	_stats.spiBytes++;
+
+	return;
+}
@@ -0,0 +1,122 @@
+#ifndef MIC_LCDSim_h
+#define MIC_LCDSim_h
+
+// Host simulation of HD44780 LCD hardware for MIC_LCD builds without Arduino
+// Arduino.h and SPI.h in this folder are host stubs: pins and SPI drive one simulated HD44780, through a 74HC595 on
+// SPI (outputs wired as MIC_LCD(BYTE LATCH)) or through parallel pins. With R/#W connected, busy flag, AC and data
+// can be read on parallel pins, and the LCD can be made to hang with its busy flag set.
+// Time is the host clock, so instructions written before the previous one has finished are real driver errors.
+// Build (from LCD/sim):
+//  g++ -std=c++11 -Wall -I. -I.. -I../.. -o MIC_LCDSimTest MIC_LCDSimTest.cpp MIC_LCDSim.cpp ../*.cpp -lpthread
+#define MIC_LCDSIM_EXECTIME_LONG	1520	// us at MIC_LCDSIM_FOSC, clear display and return home
+#define MIC_LCDSIM_EXECTIME_SHORT	37		// us at MIC_LCDSIM_FOSC, all other instructions and data write
+#define MIC_LCDSIM_FOSC				270		// kHz, nominal oscillator, execution time scales with 1 / fosc
+#define MIC_LCDSIM_POWERONTIME		40000	// us, no instruction is accepted after power on
+
+#define MIC_LCDSIM_DDRAMSIZE		128		// whole address range, 1-line mode uses 0x00 - 0x4F,
+											// 2-line mode 0x00 - 0x27 and 0x40 - 0x67
+#define MIC_LCDSIM_CGRAMSIZE		64
+
+typedef struct
+{
+	UINT32 spiBytes;			// bytes shifted into the 74HC595
+	UINT32 instructions;		// instructions executed
+	UINT32 data;				// data written
+	UINT32 busyViolations;		// EN strobes while the previous instruction or data was still executing
+	UINT32 timingViolations;	// RS changed with EN rising or while EN high, RS or DB changed with EN falling
+} MIC_LCDSIM_STATS;
+
+class MIC_LCDSim
+{
+public:
+	MIC_LCDSim(void);
+
+	// Connect the LCD to the 74HC595 latched by LATCH, or to parallel pins (0xff = not connected, RW = 0xff for R/#W
+	// tied to GND), in the order of the MIC_LCD constructors
+	void attach595(BYTE LATCH);
+	void attachParallel(BYTE RS, BYTE EN, BYTE RW,
+			BYTE DB7, BYTE DB6, BYTE DB5, BYTE DB4, BYTE DB3, BYTE DB2, BYTE DB1, BYTE DB0);
+
+	// Oscillator frequency (kHz) of the module, kept across powerOn. Datasheet range is 190 - 350kHz.
+	void oscillator(UINT16 fosc);
+
+	// Power on reset: 8 bit interface, 1-line mode, display cleared and off, AC = 0 and increment.
+	// Statistics are cleared.
+	void powerOn(void);
+
+	// SET = LCD hangs, busy flag reads set and nothing is executed until CLEAR. Kept across powerOn.
+	void stuckBusy(BYTE stuck);
+
+	// Called after every instruction or data write is executed, NULL = no hook
+	void setHook(void (*hook)(BYTE rs, BYTE value));
+
+	BYTE DDRAM(BYTE address);
+	BYTE CGRAM(BYTE address);
+	BYTE AC(void);
+	BYTE CGRAMSelected(void);	// SET = AC is a CGRAM address
+	BYTE bus8Bit(void);			// SET = 8 bit interface
+	BYTE lines2(void);			// SET = 2-line mode
+
+	// Copy length characters of DDRAM from address into text, text is terminated with 0.
+	// Characters below 0x20 (CGRAM) are shown as '0' - '7'.
+	void text(BYTE address, BYTE length, CHAR8 *text);
+
+	void getStats(MIC_LCDSIM_STATS *stats);
+
+	// Host stubs
+	void pinWrite(BYTE pin, BYTE value);
+	BYTE pinRead(BYTE pin);
+	void spiTransfer(BYTE value);
+
+private:
+	BYTE _latchPin;
+	BYTE _RS_PIN;
+	BYTE _EN_PIN;
+	BYTE _RW_PIN;
+	BYTE _DB_PIN[8];
+	BYTE _pin[256];				// parallel pin levels
+
+	BYTE _shiftRegister;		// 74HC595 shift register, moved to the outputs by a latch rising edge
+	BYTE _outputs;				// 74HC595 outputs
+
+	BYTE _DDRAM[MIC_LCDSIM_DDRAMSIZE];
+	BYTE _CGRAM[MIC_LCDSIM_CGRAMSIZE];
+	BYTE _AC;
+	BYTE _CGRAMSelected;
+	BYTE _increment;			// entry mode I/D
+	BYTE _bus8Bit;
+	BYTE _lines2;
+	BYTE _highNibble;			// 4 bit interface: first nibble of a byte
+	BYTE _nibblePending;		// 4 bit interface: SET = first nibble is received or read
+
+	UINT16 _fosc;				// kHz
+	BYTE _stuckBusy;
+	void (*_hook)(BYTE rs, BYTE value);
+	unsigned long _busyUntil;	// micros() when the instruction or data in progress is finished
+	MIC_LCDSIM_STATS _stats;
+
+	// Function: void _strobe(BYTE rs, BYTE bus)
+	// EN falling edge, bus holds DB7 - DB0 (DB3 - DB0 are ignored in 4 bit interface)
+	void _strobe(BYTE rs, BYTE bus);
+
+	// Function: void _execute(BYTE rs, BYTE value)
+	void _execute(BYTE rs, BYTE value);
+
+	// Function: BYTE _busy(void)
+	BYTE _busy(void);
+
+	// Function: void _readDone(BYTE rs)
+	// EN falling edge of a read, data read steps AC when the whole byte is read
+	void _readDone(BYTE rs);
+
+	// Function: void _stepAC(BYTE increment)
+	void _stepAC(BYTE increment);
+
+	// Function: void _outputsChanged(BYTE previous)
+	// 74HC595 latch: check RS and DB against EN edges and strobe on EN falling
+	void _outputsChanged(BYTE previous);
+};
+
+extern MIC_LCDSim MIC_Sim;
+
+#endif
@@ -0,0 +1,145 @@
+// MIC_LCDSimRenderer
+// Host test of MIC_LCDRenderer with the std::thread backend on the simulated 74HC595 and HD44780 (see MIC_LCDSim.h)
+// A producer thread hands frames and fields over at full rate while the render task owns the bus.
+// Build: g++ -std=c++11 -Wall -I. -I.. -I../.. -o MIC_LCDSimRenderer MIC_LCDSimRenderer.cpp MIC_LCDSim.cpp ../*.cpp -lpthread
+// Return the number of failed checks.
+#include "Arduino.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "MIC_GeneralDef.h"
+#include "MIC_LCD.h"
+#include "MIC_LCDRenderer.h"
+#include "MIC_LCDSim.h"
+
+#define SIM_LATCH		10
+#define SIM_SUBMITS		15000	// submits of the producer, every third one is a frame, others are fields
+#define SIM_PACING		15		// us between submits, frames are rendered while the producer runs
+
+static std::atomic<int> _failures(0);		// checked from the producer thread too
+
+#define CHECK(condition)	_check((condition), #condition, __LINE__)
+
+static void _check(bool passed, const char *condition, int line)
+{
+	if (!passed)
+	{
+		printf("  FAIL line %d: %s\n", line, condition);
+		_failures++;
+	}
+
+	return;
+}
+
+// DDRAM at address equals text
+static bool _shows(BYTE address, const char *text)
+{
+	CHAR8 shown[MIC_LCDSIM_DDRAMSIZE + 1];
+
+	MIC_Sim.text(address, strlen(text), shown);
+
+	return strcmp(shown, text) == 0;
+}
+
+static void _producer(MIC_LCDRenderer *renderer)
+{
+	CHAR8 frame[2 * 16 + 1];
+	CHAR8 field[6];
+	int counter = 0;
+	int id = 0;
+
+	for (counter = 0; counter < SIM_SUBMITS; counter++)
+	{
+		id = counter % 3;
+
+		if (id == 0)
+		{
+			snprintf(frame, sizeof(frame), "frame %-10d                ", counter);
+			CHECK(renderer->submitFrame(frame) == MIC_RC_SUCCESS);
+		}
+		else
+		{
+			snprintf(field, sizeof(field), "%d:%03d", id, counter % 1000);
+			CHECK(renderer->submitField(2, 1 + ((id - 1) * 6), field, 5) == MIC_RC_SUCCESS);
+		}
+
+		std::this_thread::sleep_for(std::chrono::microseconds(SIM_PACING));
+	}
+
+	return;
+}
+
+// Without a render task: attach, submit and render on the calling thread
+static void _renderDirect(MIC_LCD *lcd)
+{
+	MIC_LCDRenderer renderer(lcd);
+
+	CHECK(renderer.submitFrame((CHAR8 *)"no attach") != MIC_RC_SUCCESS);
+	CHECK(renderer.attach() == MIC_RC_SUCCESS);
+	CHECK(renderer.submitFrame((CHAR8 *)"rendered on the " "caller          ") == MIC_RC_SUCCESS);
+	CHECK(renderer.submitField(2, 8, (CHAR8 *)"thread", 6) == MIC_RC_SUCCESS);
+	CHECK(renderer.renderOnce() == MIC_RC_SUCCESS);
+	CHECK(_shows(0x00, "rendered on the "));
+	CHECK(_shows(0x40, "caller thread   "));
+
+	return;
+}
+
+// Renderer destroyed while its task runs: the task is stopped and joined by the destructor
+static void _destroyRunning(MIC_LCD *lcd)
+{
+	MIC_LCDRenderer renderer(lcd);
+
+	CHECK(renderer.begin(1) == MIC_RC_SUCCESS);
+	CHECK(renderer.attach() != MIC_RC_SUCCESS);
+	CHECK(renderer.submitFrame((CHAR8 *)"destroyed while " "running         ") == MIC_RC_SUCCESS);
+	delay(20);
+
+	return;
+}
+
+int main(void)
+{
+	MIC_LCD_RENDER_STATS stats;
+	MIC_LCDSIM_STATS simStats;
+	std::thread producer;
+
+	MIC_Sim.attach595(SIM_LATCH);
+	MIC_LCD lcd(SIM_LATCH);
+	MIC_LCDRenderer renderer(&lcd);
+
+	CHECK(lcd.PORST(2, 16) == MIC_RC_SUCCESS);
+
+	_renderDirect(&lcd);
+	_destroyRunning(&lcd);
+	CHECK(_shows(0x00, "destroyed while "));
+
+	CHECK(renderer.begin(1) == MIC_RC_SUCCESS);
+
+	producer = std::thread(_producer, &renderer);
+	producer.join();
+
+	// Latest frame wins, the last one is on screen after the render task has caught up
+	CHECK(renderer.submitFrame((CHAR8 *)"render task done" "on a host thread") == MIC_RC_SUCCESS);
+	delay(50);
+	renderer.end();
+
+	renderer.getStats(&stats);
+	MIC_Sim.getStats(&simStats);
+
+	printf("submitted %u, rendered %u, dropped %u\n", stats.submitted, stats.rendered, stats.dropped);
+	printf("maxSubmitLatency %u us, lastRenderTime %u us\n", stats.maxSubmitLatency, stats.lastRenderTime);
+
+	CHECK(stats.submitted == SIM_SUBMITS + 1);
+	CHECK((stats.rendered + stats.dropped) == stats.submitted);
+	CHECK(_shows(0x00, "render task done"));
+	CHECK(_shows(0x40, "on a host thread"));
+	CHECK(simStats.busyViolations == 0);
+	CHECK(simStats.timingViolations == 0);
+
+	printf("%s, %d failed checks\n", (_failures == 0) ? "PASS" : "FAIL", _failures.load());
+
+	return _failures;
+}
@@ -0,0 +1,174 @@
+// MIC_LCDSimScreenLib
+// Host round trip of the screen library: screens packed by tools/MIC_LCDScreenCompiler are decoded by
+// MIC_LCDScreenDecoder onto the simulated HD44780 (see MIC_LCDSim.h) and compared with the source text.
+// Build (from LCD/sim):
+//  g++ -std=c++11 -O2 -o MIC_LCDScreenCompiler ../tools/MIC_LCDScreenCompiler.cpp
+//  ./MIC_LCDScreenCompiler MIC_LCDSimScreens.txt MIC_LCDSimScreens.h SIM_SCREENS
+//  g++ -std=c++11 -Wall -I. -I.. -I../.. -o MIC_LCDSimScreenLib MIC_LCDSimScreenLib.cpp MIC_LCDSim.cpp ../*.cpp -lpthread
+// Return the number of failed checks.
+#include "Arduino.h"
+
+#include "MIC_GeneralDef.h"
+#include "MIC_LCD.h"
+#include "MIC_LCDScreenLib.h"
+#include "MIC_LCDSim.h"
+#include "MIC_LCDSimScreens.h"
+
+#define SIM_LATCH	10
+#define SIM_ROWS	4
+#define SIM_COLUMNS	20
+
+static int _failures = 0;
+
+#define CHECK(condition)	_check((condition), #condition, __LINE__)
+
+static void _check(bool passed, const char *condition, int line)
+{
+	if (!passed)
+	{
+		printf("  FAIL line %d: %s\n", line, condition);
+		_failures++;
+	}
+
+	return;
+}
+
+// Source text of MIC_LCDSimScreens.txt, rows padded to 20 columns
+static const char *_source[][SIM_ROWS] =
+{
+	{
+		"Temperature  21.5\xdf" "C ",
+		"Setting      22.0\xdf" "C ",
+		"\x00 Heating           ",
+		"Menu: Setting       "
+	},
+	{
+		"                    ",
+		"                    ",
+		"                    ",
+		"                    "
+	},
+	{
+		"Setting: Temperature",
+		"  Temperature 22.0  ",
+		"  Setting saved     ",
+		"abababababababababab"
+	},
+	{
+		"aaaaaaaaaaaaaaaaaaaa",
+		"abababababababababab",
+		"a\\b    \x01\x02\x03\x80\xff         ",
+		"                    "
+	},
+	{
+		"Temperature  21.5\xdf" "C ",
+		"Setting      22.0\xdf" "C ",
+		"\x00 Heating           ",
+		"Menu: Setting       "
+	}
+};
+
+// DDRAM address of each row on a standard 20x4 module
+static const BYTE _rowAddress[SIM_ROWS] = {0x00, 0x40, 0x14, 0x54};
+
+// LCD shows the source text of a screen, characters are compared as stored (CGRAM codes included)
+static bool _showsScreen(UINT16 screenID)
+{
+	BYTE row = 0;
+	BYTE column = 0;
+
+	for (row = 0; row < SIM_ROWS; row++)
+	{
+		for (column = 0; column < SIM_COLUMNS; column++)
+		{
+			if (MIC_Sim.DDRAM(_rowAddress[row] + column) != (BYTE)_source[screenID][row][column])
+			{
+				printf("  screen %u row %u column %u: 0x%02x\n", screenID, row + 1, column + 1,
+					MIC_Sim.DDRAM(_rowAddress[row] + column));
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+// Characters different between two screens
+static UINT32 _difference(UINT16 from, UINT16 to)
+{
+	UINT32 difference = 0;
+	BYTE row = 0;
+	BYTE column = 0;
+
+	for (row = 0; row < SIM_ROWS; row++)
+	{
+		for (column = 0; column < SIM_COLUMNS; column++)
+		{
+			difference += (_source[from][row][column] != _source[to][row][column]) ? 1 : 0;
+		}
+	}
+
+	return difference;
+}
+
+static UINT32 _dataWrites(void)
+{
+	MIC_LCDSIM_STATS stats;
+
+	MIC_Sim.getStats(&stats);
+
+	return stats.data;
+}
+
+int main(void)
+{
+	MIC_LCDSIM_STATS stats;
+	CHAR8 shown[SIM_ROWS * SIM_COLUMNS];
+	UINT16 screenID = 0;
+	UINT16 previous = 0;
+	UINT32 writes = 0;
+	BYTE row = 0;
+
+	MIC_Sim.attach595(SIM_LATCH);
+	MIC_LCD lcd(SIM_LATCH);
+	MIC_LCDScreenDecoder decoder(&SIM_SCREENS);
+
+	CHECK(SIM_SCREENS.screenCount == (sizeof(_source) / sizeof(_source[0])));
+	CHECK(lcd.PORST(SIM_ROWS, SIM_COLUMNS) == MIC_RC_SUCCESS);
+
+	// Identical screens share one code stream
+	CHECK(pgm_read_word(&SIM_SCREENS.screenIndex[SIM_SCREENS_MAIN]) ==
+		pgm_read_word(&SIM_SCREENS.screenIndex[SIM_SCREENS_MAIN_COPY]));
+
+	// Every screen streamed in full
+	for (screenID = 0; screenID < SIM_SCREENS.screenCount; screenID++)
+	{
+		CHECK(decoder.displayScreen(&lcd, screenID) == MIC_RC_SUCCESS);
+		CHECK(_showsScreen(screenID));
+	}
+	CHECK(decoder.displayScreen(&lcd, SIM_SCREENS.screenCount) != MIC_RC_SUCCESS);
+
+	// Diff against what is shown writes only the characters that differ
+	for (row = 0; row < SIM_ROWS; row++)
+	{
+		memcpy(&shown[row * SIM_COLUMNS], _source[SIM_SCREENS.screenCount - 1][row], SIM_COLUMNS);
+	}
+	previous = SIM_SCREENS.screenCount - 1;
+
+	for (screenID = 0; screenID < SIM_SCREENS.screenCount; screenID++)
+	{
+		writes = _dataWrites();
+		CHECK(decoder.displayScreenDiff(&lcd, screenID, shown) == MIC_RC_SUCCESS);
+		CHECK(_showsScreen(screenID));
+		CHECK((_dataWrites() - writes) == _difference(previous, screenID));
+		previous = screenID;
+	}
+
+	MIC_Sim.getStats(&stats);
+	CHECK(stats.busyViolations == 0);
+	CHECK(stats.timingViolations == 0);
+
+	printf("%s, %d failed checks\n", (_failures == 0) ? "PASS" : "FAIL", _failures);
+
+	return _failures;
+}
@@ -0,0 +1,847 @@
+// MIC_LCDSimTest
+// Host test of MIC_LCD against the simulated 74HC595 and HD44780 (see MIC_LCDSim.h)
+// Build: g++ -std=c++11 -Wall -I. -I.. -I../.. -o MIC_LCDSimTest MIC_LCDSimTest.cpp MIC_LCDSim.cpp ../*.cpp -lpthread
+// Return the number of failed checks.
+#include "Arduino.h"
+
+#include "MIC_GeneralDef.h"
+#include "MIC_LCD.h"
+#include "MIC_LCDAnimator.h"
+#include "MIC_LCDBigNum.h"
+#include "MIC_LCDCompositor.h"
+#include "MIC_LCDConsole.h"
+#include "MIC_LCDScheduler.h"
+#include "MIC_LCDSim.h"
+
+#define SIM_LATCH	10
+
+static int _failures = 0;
+
+#define CHECK(condition)	_check((condition), #condition, __LINE__)
+
+static void _check(bool passed, const char *condition, int line)
+{
+	if (!passed)
+	{
+		printf("  FAIL line %d: %s\n", line, condition);
+		_failures++;
+	}
+
+	return;
+}
+
+// DDRAM at address equals text
+static bool _shows(BYTE address, const char *text)
+{
+	CHAR8 shown[MIC_LCDSIM_DDRAMSIZE + 1];
+
+	MIC_Sim.text(address, strlen(text), shown);
+
+	return strcmp(shown, text) == 0;
+}
+
+// No write while LCD was busy, RS and DB stable across EN edges
+static void _checkBus(void)
+{
+	MIC_LCDSIM_STATS stats;
+
+	MIC_Sim.getStats(&stats);
+	CHECK(stats.busyViolations == 0);
+	CHECK(stats.timingViolations == 0);
+
+	return;
+}
+
+// Screen, CGRAM and 4 bit initialization over the 74HC595
+static void testTransport595(void)
+{
+	const BYTE glyph[MIC_LCD_CGRAMGLYPHSIZE] = {0x0e, 0x11, 0x11, 0x1f, 0x1b, 0x1b, 0x1f, 0x00};
+	MIC_LCDSIM_STATS stats;
+	UINT32 spiBytes = 0;
+	BYTE counter = 0;
+
+	printf("testTransport595\n");
+
+	MIC_Sim.powerOn();
+	MIC_Sim.attach595(SIM_LATCH);
+	MIC_LCD lcd(SIM_LATCH);
+
+	CHECK(lcd.PORST(2, 16) == MIC_RC_SUCCESS);
+	CHECK(MIC_Sim.bus8Bit() == CLEAR);
+	CHECK(MIC_Sim.lines2() == SET);
+
+	MIC_Sim.getStats(&stats);
+	spiBytes = stats.spiBytes;
+
+	CHECK(lcd.displayStr(1, 1, (CHAR8 *)"74HC595 on SPI", 14) == MIC_RC_SUCCESS);
+	CHECK(lcd.displayStr(2, 3, (CHAR8 *)"write only", 10) == MIC_RC_SUCCESS);
+	CHECK(_shows(0x00, "74HC595 on SPI  "));
+	CHECK(_shows(0x40, "  write only    "));
+
+	// 4 latches per instruction or character, one more latch only when RS changes.
+	// Row 1 needs no set address, AC is 0x00 after PORST.
+	MIC_Sim.getStats(&stats);
+	CHECK((stats.spiBytes - spiBytes) == (1 + (14 * 4)) + (1 + 4 + 1 + (10 * 4)));
+
+	CHECK(lcd.createChar(1, (BYTE *)glyph) == MIC_RC_SUCCESS);
+	for (counter = 0; counter < MIC_LCD_CGRAMGLYPHSIZE; counter++)
+	{
+		CHECK(MIC_Sim.CGRAM(MIC_LCD_CGRAMGLYPHSIZE + counter) == glyph[counter]);
+	}
+	// Cursor is kept by createChar
+	CHECK(lcd.putChar(0x01) == MIC_RC_SUCCESS);
+	CHECK(MIC_Sim.DDRAM(0x4c) == 0x01);
+
+	// PORST again on a bus already in 4 bit mode: interface is synchronized again by the 8 bit sequence
+	CHECK(lcd.PORST(2, 16) == MIC_RC_SUCCESS);
+	CHECK(MIC_Sim.bus8Bit() == CLEAR);
+	CHECK(lcd.displayStr(2, 1, (CHAR8 *)"again", 5) == MIC_RC_SUCCESS);
+	CHECK(_shows(0x00, "                "));
+	CHECK(_shows(0x40, "again           "));
+
+	// AC is not known after a function set, the cell address is set again even when AC points to it
+	CHECK(lcd.DisplayMode2Line() == MIC_RC_SUCCESS);
+	MIC_Sim.getStats(&stats);
+	spiBytes = stats.spiBytes;
+	CHECK(lcd.displayStr(2, 6, (CHAR8 *)"!", 1) == MIC_RC_SUCCESS);
+	MIC_Sim.getStats(&stats);
+	CHECK((stats.spiBytes - spiBytes) == 4 + 1 + 4);
+	CHECK(_shows(0x40, "again!          "));
+
+	_checkBus();
+
+	return;
+}
+
+// Same screen through parallel pins, 4 and 8 bit bus, write only
+static void testParallel(void)
+{
+	printf("testParallel\n");
+
+	MIC_Sim.powerOn();
+	MIC_Sim.attachParallel(2, 3, 0xff, 7, 6, 5, 4, 0xff, 0xff, 0xff, 0xff);
+	MIC_LCD lcd4(2, 3, 0xff, 7, 6, 5, 4, 0xff, 0xff, 0xff, 0xff);
+
+	CHECK(lcd4.PORST(2, 16) == MIC_RC_SUCCESS);
+	CHECK(MIC_Sim.bus8Bit() == CLEAR);
+	CHECK(lcd4.displayStr(2, 1, (CHAR8 *)"4 bit bus", 9) == MIC_RC_SUCCESS);
+	CHECK(_shows(0x40, "4 bit bus"));
+	_checkBus();
+
+	MIC_Sim.powerOn();
+	MIC_Sim.attachParallel(2, 3, 0xff, 11, 10, 9, 8, 7, 6, 5, 4);
+	MIC_LCD lcd8(2, 3, 0xff, 11, 10, 9, 8, 7, 6, 5, 4);
+
+	CHECK(lcd8.PORST(2, 16) == MIC_RC_SUCCESS);
+	CHECK(MIC_Sim.bus8Bit() == SET);
+	CHECK(lcd8.displayStr(1, 4, (CHAR8 *)"8 bit bus", 9) == MIC_RC_SUCCESS);
+	CHECK(_shows(0x00, "   8 bit bus"));
+	_checkBus();
+
+	return;
+}
+
+// CGRAM upload and cursor tracking with decrement entry mode
+static void testEntryMode(void)
+{
+	const BYTE glyph[MIC_LCD_CGRAMGLYPHSIZE] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+	BYTE counter = 0;
+
+	printf("testEntryMode\n");
+
+	MIC_Sim.powerOn();
+	MIC_Sim.attach595(SIM_LATCH);
+	MIC_LCD lcd(SIM_LATCH);
+
+	CHECK(lcd.PORST(2, 16) == MIC_RC_SUCCESS);
+
+	// Glyph goes to its own slot in order, entry mode and cursor are kept
+	CHECK(lcd.entryModeCursorLeft() == MIC_RC_SUCCESS);
+	CHECK(lcd.setCursor(1, 8) == MIC_RC_SUCCESS);
+	CHECK(lcd.createChar(1, (BYTE *)glyph) == MIC_RC_SUCCESS);
+	for (counter = 0; counter < MIC_LCD_CGRAMGLYPHSIZE; counter++)
+	{
+		CHECK(MIC_Sim.CGRAM(counter) == 0x00);
+		CHECK(MIC_Sim.CGRAM(MIC_LCD_CGRAMGLYPHSIZE + counter) == glyph[counter]);
+	}
+	CHECK(lcd.putChar('b') == MIC_RC_SUCCESS);
+	CHECK(lcd.putChar('a') == MIC_RC_SUCCESS);
+	CHECK(_shows(0x06, "ab"));
+
+	// Clear display sets entry mode to increment, cursor is not skipped by a stale address counter
+	CHECK(lcd.clearDisplay() == MIC_RC_SUCCESS);
+	CHECK(lcd.setCursor(1, 5) == MIC_RC_SUCCESS);
+	CHECK(lcd.putChar('X') == MIC_RC_SUCCESS);
+	CHECK(lcd.setCursor(1, 4) == MIC_RC_SUCCESS);
+	CHECK(lcd.putChar('Y') == MIC_RC_SUCCESS);
+	CHECK(_shows(0x00, "   YX "));
+
+	_checkBus();
+
+	return;
+}
+
+// A budget smaller than one frame still uploads the most overdue frame
+static void testAnimatorBudget(void)
+{
+	static const BYTE frames[2 * MIC_LCD_CGRAMGLYPHSIZE] PROGMEM =
+	{
+		0x1f, 0x00, 0x1f, 0x00, 0x1f, 0x00, 0x1f, 0x00,
+		0x00, 0x1f, 0x00, 0x1f, 0x00, 0x1f, 0x00, 0x1f
+	};
+
+	printf("testAnimatorBudget\n");
+
+	MIC_Sim.powerOn();
+	MIC_Sim.attach595(SIM_LATCH);
+	MIC_LCD lcd(SIM_LATCH);
+	MIC_LCDAnimator animator(&lcd);
+
+	CHECK(lcd.PORST(2, 16) == MIC_RC_SUCCESS);
+	CHECK(animator.play(2, frames, 2, 100) == MIC_RC_SUCCESS);
+	CHECK(animator.play(3, frames, 2, 100) == MIC_RC_SUCCESS);
+	CHECK(animator.tick(MIC_LCD_ANIM_BYTESPERFRAME / 2) == MIC_RC_SUCCESS);
+	CHECK((MIC_Sim.CGRAM(2 * MIC_LCD_CGRAMGLYPHSIZE) == 0x1f) != (MIC_Sim.CGRAM(3 * MIC_LCD_CGRAMGLYPHSIZE) == 0x1f));
+	CHECK(animator.tick(MIC_LCD_ANIM_BYTESPERFRAME / 2) == MIC_RC_SUCCESS);
+	CHECK(MIC_Sim.CGRAM(2 * MIC_LCD_CGRAMGLYPHSIZE) == 0x1f);
+	CHECK(MIC_Sim.CGRAM(3 * MIC_LCD_CGRAMGLYPHSIZE) == 0x1f);
+
+	_checkBus();
+
+	return;
+}
+
+// Brownout in decrement entry mode: CGRAM and DDRAM are restored in order, entry mode after
+static void testRecover(void)
+{
+	const BYTE glyph[MIC_LCD_CGRAMGLYPHSIZE] = {0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18};
+	MIC_LCD_SNAPSHOT snapshot;
+	BYTE counter = 0;
+
+	printf("testRecover\n");
+
+	MIC_Sim.powerOn();
+	MIC_Sim.attach595(SIM_LATCH);
+	MIC_LCD lcd(SIM_LATCH);
+
+	CHECK(lcd.PORST(2, 16) == MIC_RC_SUCCESS);
+	CHECK(lcd.attachSnapshot(&snapshot) == MIC_RC_SUCCESS);
+	CHECK(lcd.createChar(1, (BYTE *)glyph) == MIC_RC_SUCCESS);
+	CHECK(lcd.displayStr(1, 1, (CHAR8 *)"recover", 7) == MIC_RC_SUCCESS);
+	CHECK(lcd.displayStr(2, 10, (CHAR8 *)"\x01 ok", 4) == MIC_RC_SUCCESS);
+	CHECK(lcd.entryModeCursorLeft() == MIC_RC_SUCCESS);
+	CHECK(lcd.setCursor(2, 5) == MIC_RC_SUCCESS);
+
+	MIC_Sim.powerOn();
+	CHECK(lcd.recover() == MIC_RC_SUCCESS);
+
+	for (counter = 0; counter < MIC_LCD_CGRAMGLYPHSIZE; counter++)
+	{
+		CHECK(MIC_Sim.CGRAM(counter) == 0x00);
+		CHECK(MIC_Sim.CGRAM(MIC_LCD_CGRAMGLYPHSIZE + counter) == glyph[counter]);
+	}
+	CHECK(_shows(0x00, "recover "));
+	CHECK(_shows(0x40, "         1 ok "));
+	CHECK(MIC_Sim.AC() == 0x44);
+
+	// Entry mode is decrement again
+	CHECK(lcd.putChar('b') == MIC_RC_SUCCESS);
+	CHECK(lcd.putChar('a') == MIC_RC_SUCCESS);
+	CHECK(_shows(0x43, "ab"));
+
+	_checkBus();
+
+	return;
+}
+
+// Characters written to DDRAM or CGRAM since power on
+static UINT32 _dataWrites(void)
+{
+	MIC_LCDSIM_STATS stats;
+
+	MIC_Sim.getStats(&stats);
+
+	return stats.data;
+}
+
+// Layers in z order, cells outside of windows are transparent, only changed cells are written
+static void testCompositor(void)
+{
+	UINT32 writes = 0;
+
+	printf("testCompositor\n");
+
+	MIC_Sim.powerOn();
+	MIC_Sim.attach595(SIM_LATCH);
+	MIC_LCD lcd(SIM_LATCH);
+	MIC_LCDCompositor compositor(&lcd);
+
+	// Nothing is shown before PORST, first refresh after it writes every cell
+	CHECK(compositor.refresh() != MIC_RC_SUCCESS);
+	CHECK(lcd.PORST(2, 16) == MIC_RC_SUCCESS);
+	writes = _dataWrites();
+	CHECK(compositor.refresh() == MIC_RC_SUCCESS);
+	CHECK((_dataWrites() - writes) == 32);
+
+	CHECK(compositor.openLayer(MIC_LCD_LAYER_BASE, 1, 1, 2, 16) == MIC_RC_SUCCESS);
+	CHECK(compositor.layerStr(MIC_LCD_LAYER_BASE, 1, 1, (CHAR8 *)"0123456789abcdef", 16) == MIC_RC_SUCCESS);
+	CHECK(compositor.layerStr(MIC_LCD_LAYER_BASE, 2, 1, (CHAR8 *)"ghijklmnopqrstuv", 16) == MIC_RC_SUCCESS);
+	CHECK(compositor.openLayer(MIC_LCD_LAYER_STATUS, 1, 13, 1, 4) == MIC_RC_SUCCESS);
+	CHECK(compositor.layerStr(MIC_LCD_LAYER_STATUS, 1, 1, (CHAR8 *)"STAT", 4) == MIC_RC_SUCCESS);
+	CHECK(compositor.openLayer(MIC_LCD_LAYER_POPUP, 1, 12, 2, 3) == MIC_RC_SUCCESS);
+	CHECK(compositor.layerStr(MIC_LCD_LAYER_POPUP, 1, 1, (CHAR8 *)"P1", 2) == MIC_RC_SUCCESS);
+	CHECK(compositor.layerStr(MIC_LCD_LAYER_POPUP, 2, 1, (CHAR8 *)"P2", 2) == MIC_RC_SUCCESS);
+	CHECK(compositor.refresh() == MIC_RC_SUCCESS);
+
+	// Popup covers status and base, space in a window is not transparent
+	CHECK(_shows(0x00, "0123456789aP1 AT"));
+	CHECK(_shows(0x40, "ghijklmnopqP2 uv"));
+
+	// No change, or a change hidden under a higher layer, writes nothing
+	writes = _dataWrites();
+	CHECK(compositor.refresh() == MIC_RC_SUCCESS);
+	CHECK(compositor.layerStr(MIC_LCD_LAYER_BASE, 1, 13, (CHAR8 *)"X", 1) == MIC_RC_SUCCESS);
+	CHECK(compositor.layerStr(MIC_LCD_LAYER_STATUS, 1, 1, (CHAR8 *)"Q", 1) == MIC_RC_SUCCESS);
+	CHECK(compositor.refresh() == MIC_RC_SUCCESS);
+	CHECK(_dataWrites() == writes);
+
+	// Closing the popup restores only the cells it covered
+	CHECK(compositor.closeLayer(MIC_LCD_LAYER_POPUP) == MIC_RC_SUCCESS);
+	CHECK(compositor.refresh() == MIC_RC_SUCCESS);
+	CHECK((_dataWrites() - writes) == 6);
+	CHECK(_shows(0x00, "0123456789abQTAT"));
+	CHECK(_shows(0x40, "ghijklmnopqrstuv"));
+
+	// Cells no layer covers are space
+	CHECK(compositor.closeLayer(MIC_LCD_LAYER_BASE) == MIC_RC_SUCCESS);
+	CHECK(compositor.refresh() == MIC_RC_SUCCESS);
+	CHECK(_shows(0x00, "            QTAT"));
+	CHECK(_shows(0x40, "                "));
+
+	// LCD cleared behind the compositor: invalidate writes every cell again
+	CHECK(lcd.clearDisplay() == MIC_RC_SUCCESS);
+	compositor.invalidate();
+	writes = _dataWrites();
+	CHECK(compositor.refresh() == MIC_RC_SUCCESS);
+	CHECK((_dataWrites() - writes) == 32);
+	CHECK(_shows(0x00, "            QTAT"));
+
+	_checkBus();
+
+	return;
+}
+
+// Flush count of a region
+static UINT16 _flushed(MIC_LCDScheduler *scheduler, BYTE regionID)
+{
+	MIC_LCD_REGION_STATS stats;
+
+	scheduler->regionStats(regionID, &stats);
+
+	return stats.flushCount;
+}
+
+// Region order by priority and deadline, tick budget and deadline miss statistics
+static void testScheduler(void)
+{
+	MIC_LCD_REGION_STATS stats;
+	BYTE clock = 0;
+	BYTE alarm = 0;
+	BYTE menu = 0;
+	BYTE log = 0;
+
+	printf("testScheduler\n");
+
+	MIC_Sim.powerOn();
+	MIC_Sim.attach595(SIM_LATCH);
+	MIC_LCD lcd(SIM_LATCH);
+	MIC_LCDScheduler scheduler(&lcd);
+
+	CHECK(lcd.PORST(2, 16) == MIC_RC_SUCCESS);
+	CHECK(scheduler.addRegion(1, 1, 5, 1, 1000, &clock) == MIC_RC_SUCCESS);
+	CHECK(scheduler.addRegion(1, 7, 4, 0, 1000, &alarm) == MIC_RC_SUCCESS);
+	CHECK(scheduler.addRegion(2, 1, 6, 1, 100, &menu) == MIC_RC_SUCCESS);
+	CHECK(scheduler.addRegion(2, 9, 3, 2, 20, &log) == MIC_RC_SUCCESS);
+	CHECK(scheduler.updateRegion(clock, (CHAR8 *)"12:00") == MIC_RC_SUCCESS);
+	CHECK(scheduler.updateRegion(alarm, (CHAR8 *)"ALRM") == MIC_RC_SUCCESS);
+	CHECK(scheduler.updateRegion(menu, (CHAR8 *)"menu 1") == MIC_RC_SUCCESS);
+	CHECK(scheduler.updateRegion(log, (CHAR8 *)"log") == MIC_RC_SUCCESS);
+
+	// A budget too small for any region flushes the most urgent one only: priority, then the earliest deadline
+	CHECK(scheduler.tick(1) == MIC_RC_SUCCESS);
+	CHECK(_flushed(&scheduler, alarm) == 1);
+	CHECK(_flushed(&scheduler, clock) + _flushed(&scheduler, menu) + _flushed(&scheduler, log) == 0);
+	CHECK(scheduler.tick(1) == MIC_RC_SUCCESS);
+	CHECK(_flushed(&scheduler, menu) == 1);
+	CHECK(scheduler.tick(1) == MIC_RC_SUCCESS);
+	CHECK(_flushed(&scheduler, clock) == 1);
+	CHECK(scheduler.tick(1) == MIC_RC_SUCCESS);
+	CHECK(_flushed(&scheduler, log) == 1);
+	CHECK(_shows(0x00, "12:00 ALRM"));
+	CHECK(_shows(0x40, "menu 1  log"));
+	CHECK(scheduler.deadlineMisses() == 0);
+
+	// Enough budget flushes every dirty region in one tick, an unchanged text does not make a region dirty.
+	// Budget leaves room for the host thread to be preempted.
+	CHECK(scheduler.updateRegion(clock, (CHAR8 *)"12:01") == MIC_RC_SUCCESS);
+	CHECK(scheduler.updateRegion(alarm, (CHAR8 *)"ALRM") == MIC_RC_SUCCESS);
+	CHECK(scheduler.updateRegion(menu, (CHAR8 *)"menu 2") == MIC_RC_SUCCESS);
+	CHECK(scheduler.tick(60000) == MIC_RC_SUCCESS);
+	CHECK(_flushed(&scheduler, clock) == 2);
+	CHECK(_flushed(&scheduler, alarm) == 1);
+	CHECK(_flushed(&scheduler, menu) == 2);
+	CHECK(_shows(0x00, "12:01 ALRM"));
+	CHECK(_shows(0x40, "menu 2  log"));
+
+	// Regions past their deadline go before an on time region of higher priority.
+	// The miss is counted once per change, also for the region still waiting after the first tick.
+	CHECK(scheduler.updateRegion(alarm, (CHAR8 *)"WAKE") == MIC_RC_SUCCESS);
+	CHECK(scheduler.updateRegion(menu, (CHAR8 *)"menu 3") == MIC_RC_SUCCESS);
+	CHECK(scheduler.updateRegion(log, (CHAR8 *)"err") == MIC_RC_SUCCESS);
+	delay(150);
+	CHECK(scheduler.tick(1) == MIC_RC_SUCCESS);
+	CHECK(_flushed(&scheduler, menu) == 3);
+	CHECK(_flushed(&scheduler, log) == 1);
+	CHECK(_flushed(&scheduler, alarm) == 1);
+	CHECK(scheduler.deadlineMisses() == 2);
+	CHECK(scheduler.tick(1) == MIC_RC_SUCCESS);
+	CHECK(_flushed(&scheduler, log) == 2);
+	CHECK(scheduler.tick(1) == MIC_RC_SUCCESS);
+	CHECK(_flushed(&scheduler, alarm) == 2);
+	CHECK(_shows(0x00, "12:01 WAKE"));
+	CHECK(_shows(0x40, "menu 3  err"));
+
+	CHECK(scheduler.regionStats(log, &stats) == MIC_RC_SUCCESS);
+	CHECK(stats.deadlineMiss == 1);
+	CHECK(stats.maxLatency >= 150);
+	CHECK(stats.busTime > 0);
+	CHECK(scheduler.regionStats(alarm, &stats) == MIC_RC_SUCCESS);
+	CHECK(stats.deadlineMiss == 0);
+	CHECK(scheduler.deadlineMisses() == 2);
+
+	scheduler.resetStats();
+	CHECK(scheduler.deadlineMisses() == 0);
+	CHECK(_flushed(&scheduler, menu) == 0);
+
+	_checkBus();
+
+	return;
+}
+
+// Console history and region text are laid out for 40 columns at runtime
+static void testWideScreen(void)
+{
+	CHAR8 history[6 * 40];
+	BYTE regionID = 0;
+	BYTE counter = 0;
+	CHAR8 line[48];
+
+	printf("testWideScreen\n");
+
+	MIC_Sim.powerOn();
+	MIC_Sim.attach595(SIM_LATCH);
+	MIC_LCD lcd(SIM_LATCH);
+	MIC_LCDConsole console(&lcd, history, sizeof(history));
+	MIC_LCDScheduler scheduler(&lcd);
+
+	CHECK(console.print((CHAR8 *)"before PORST") != MIC_RC_SUCCESS);
+	CHECK(lcd.PORST(2, 40) == MIC_RC_SUCCESS);
+
+	// 6 history lines of 40 columns
+	for (counter = 1; counter <= 8; counter++)
+	{
+		snprintf(line, sizeof(line), "line %d%34d", counter, counter);
+		CHECK(console.print(line) == MIC_RC_SUCCESS);
+	}
+	CHECK(_shows(0x00, "line 7                                 7"));
+	CHECK(_shows(0x40, "line 8                                 8"));
+	CHECK(console.scrollUp(10) == MIC_RC_SUCCESS);
+	CHECK(_shows(0x00, "line 3                                 3"));
+	CHECK(_shows(0x40, "line 4                                 4"));
+
+	// Buffer has to hold more lines than LCD rows
+	MIC_LCDConsole small(&lcd, history, 2 * 40);
+	CHECK(small.print((CHAR8 *)"too small") != MIC_RC_SUCCESS);
+
+	// Region text pool holds MIC_LCD_SCHED_TEXTSIZE characters including terminators
+	CHECK(scheduler.addRegion(2, 31, 10, 0, 100, &regionID) == MIC_RC_SUCCESS);
+	CHECK(scheduler.addRegion(1, 1, 40, 1, 100, &counter) == MIC_RC_SUCCESS);
+	CHECK(scheduler.addRegion(2, 1, 40, 1, 100, &counter) != MIC_RC_SUCCESS);
+	CHECK(scheduler.updateRegion(regionID, (CHAR8 *)"region 40") == MIC_RC_SUCCESS);
+	CHECK(scheduler.tick(60000) == MIC_RC_SUCCESS);
+	CHECK(_shows(0x40 + 30, "region 40 "));
+
+	_checkBus();
+
+	return;
+}
+
+// Slowest oscillator of the datasheet: write only timing still waits out every instruction
+// Every row of a profile written from column 1 lands at its DDRAM row offset
+static void _checkProfile(const MIC_LCD_GEOMETRY *geometry)
+{
+	CHAR8 line[MIC_LCD_MAXCOLUMN + 1];
+	BYTE row = 0;
+
+	MIC_Sim.powerOn();
+	MIC_Sim.attach595(SIM_LATCH);
+	MIC_LCD lcd(SIM_LATCH, geometry);
+
+	CHECK(lcd.PORST(geometry->rows, geometry->columns) == MIC_RC_SUCCESS);
+	CHECK(MIC_Sim.lines2() == SET);
+
+	for (row = 0; row < geometry->rows; row++)
+	{
+		memset(line, 'a' + row, geometry->columns);
+		line[0] = '1' + row;
+		line[geometry->columns - 1] = '1' + row;
+		line[geometry->columns] = 0;
+
+		CHECK(lcd.displayStr(row + 1, 1, line, geometry->columns) == MIC_RC_SUCCESS);
+		CHECK(_shows(geometry->rowOffset[row], line));
+	}
+
+	_checkBus();
+
+	return;
+}
+
+// Built-in profiles, split 16x1 and a PORST not matching the geometry
+static void testGeometry(void)
+{
+	MIC_LCDSIM_STATS stats;
+	UINT32 instructions = 0;
+
+	printf("testGeometry\n");
+
+	_checkProfile(&MIC_LCD_GEOMETRY_16X4);
+	CHECK(_shows(0x10, "3cccccccccccccc3"));
+	CHECK(_shows(0x50, "4dddddddddddddd4"));
+	_checkProfile(&MIC_LCD_GEOMETRY_20X4);
+	CHECK(_shows(0x14, "3cccccccccccccccccc3"));
+	CHECK(_shows(0x54, "4dddddddddddddddddd4"));
+	_checkProfile(&MIC_LCD_GEOMETRY_40X2);
+	CHECK(_shows(0x00, "1aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa1"));
+	CHECK(_shows(0x40, "2bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb2"));
+
+	// 16x1 type 1: columns 9 - 16 are at 0x40, LCD runs in 2-line mode
+	MIC_Sim.powerOn();
+	MIC_Sim.attach595(SIM_LATCH);
+	MIC_LCD lcd(SIM_LATCH);
+
+	CHECK(lcd.setGeometry(&MIC_LCD_GEOMETRY_16X1_SPLIT) == MIC_RC_SUCCESS);
+	CHECK(lcd.PORST(1, 16) == MIC_RC_SUCCESS);
+	CHECK(MIC_Sim.lines2() == SET);
+	CHECK(lcd.displayStr(1, 1, (CHAR8 *)"left8...right 8!", 16) == MIC_RC_SUCCESS);
+	CHECK(_shows(0x00, "left8..."));
+	CHECK(_shows(0x40, "right 8!"));
+	CHECK(lcd.setCursor(1, 9) == MIC_RC_SUCCESS);
+	CHECK(lcd.putChar('R') == MIC_RC_SUCCESS);
+	CHECK(MIC_Sim.DDRAM(0x40) == 'R');
+
+	// Other rows and columns than the geometry: error, nothing is written and the geometry is kept
+	MIC_Sim.getStats(&stats);
+	instructions = stats.instructions;
+	CHECK(lcd.PORST(2, 16) != MIC_RC_SUCCESS);
+	MIC_Sim.getStats(&stats);
+	CHECK(stats.instructions == instructions);
+	CHECK(lcd.getRow() == 1);
+	CHECK(lcd.getColumn() == 16);
+	CHECK(lcd.setCursor(1, 16) == MIC_RC_SUCCESS);
+	CHECK(lcd.putChar('?') == MIC_RC_SUCCESS);
+	CHECK(MIC_Sim.DDRAM(0x47) == '?');
+
+	_checkBus();
+
+	return;
+}
+
+// Big digits on 20x4: glyph upload, cells drawn, one changed digit rewrites only its changed cells
+static void testBigNum(void)
+{
+	const BYTE font2Glyph[8 * MIC_LCD_CGRAMGLYPHSIZE] =
+	{
+		0x07, 0x0f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f,
+		0x1f, 0x1f, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x1c, 0x1e, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f,
+		0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x0f, 0x07,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0x1f, 0x1f,
+		0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1e, 0x1c,
+		0x1f, 0x1f, 0x1f, 0x00, 0x00, 0x00, 0x1f, 0x1f,
+		0x1f, 0x00, 0x00, 0x00, 0x00, 0x1f, 0x1f, 0x1f
+	};
+	const BYTE font4Glyph[2 * MIC_LCD_CGRAMGLYPHSIZE] =
+	{
+		0x1f, 0x1f, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0x1f, 0x1f
+	};
+	UINT32 writes = 0;
+	BYTE counter = 0;
+
+	printf("testBigNum\n");
+
+	MIC_Sim.powerOn();
+	MIC_Sim.attach595(SIM_LATCH);
+	MIC_LCD lcd(SIM_LATCH);
+	MIC_LCDBigNum bigNum(&lcd);
+
+	CHECK(lcd.PORST(4, 20) == MIC_RC_SUCCESS);
+	CHECK(bigNum.displayTime(12, 34) != MIC_RC_SUCCESS);
+	CHECK(bigNum.begin(MIC_LCD_BIGNUM_2ROW, 3, 1, 21) != MIC_RC_SUCCESS);
+	CHECK(bigNum.begin(MIC_LCD_BIGNUM_2ROW, 1, 1, 20) == MIC_RC_SUCCESS);
+
+	for (counter = 0; counter < sizeof(font2Glyph); counter++)
+	{
+		CHECK(MIC_Sim.CGRAM(counter) == font2Glyph[counter]);
+	}
+
+	// "12:34" right aligned, 3 column digits with a blank column between them, glyphs read as '0' - '7'
+	CHECK(bigNum.displayTime(12, 34) == MIC_RC_SUCCESS);
+	CHECK(_shows(0x00, "     12  662\xa5" "662 34\xff"));
+	CHECK(_shows(0x40, "     4\xff" "4 377\xa5" "775   \xff"));
+	CHECK(_shows(0x14, "                    "));
+	CHECK(_shows(0x54, "                    "));
+
+	// '4' -> '5' differs in all 6 cells, '8' -> '9' in the lower left cell only
+	writes = _dataWrites();
+	CHECK(bigNum.displayTime(12, 35) == MIC_RC_SUCCESS);
+	CHECK((_dataWrites() - writes) == 6);
+	CHECK(_shows(0x00, "     12  662\xa5" "662 \xff" "66"));
+	CHECK(_shows(0x40, "     4\xff" "4 377\xa5" "775 775"));
+
+	CHECK(bigNum.displayTime(12, 38) == MIC_RC_SUCCESS);
+	writes = _dataWrites();
+	CHECK(bigNum.displayTime(12, 39) == MIC_RC_SUCCESS);
+	CHECK((_dataWrites() - writes) == 1);
+	CHECK(MIC_Sim.DDRAM(0x40 + 17) == 0x07);
+
+	writes = _dataWrites();
+	CHECK(bigNum.displayTime(12, 39) == MIC_RC_SUCCESS);
+	CHECK((_dataWrites() - writes) == 0);
+
+	// Whole area is written after invalidate
+	bigNum.invalidate();
+	writes = _dataWrites();
+	CHECK(bigNum.displayTime(12, 39) == MIC_RC_SUCCESS);
+	CHECK((_dataWrites() - writes) == 2 * 20);
+
+	// 4 row font: 2 glyphs, '8' has all segments
+	CHECK(bigNum.begin(MIC_LCD_BIGNUM_4ROW, 1, 1, 20) == MIC_RC_SUCCESS);
+	for (counter = 0; counter < sizeof(font4Glyph); counter++)
+	{
+		CHECK(MIC_Sim.CGRAM(counter) == font4Glyph[counter]);
+	}
+	CHECK(bigNum.displayNum(8, 0) == MIC_RC_SUCCESS);
+	CHECK(MIC_Sim.DDRAM(0x00 + 17) == 0xff);
+	CHECK(MIC_Sim.DDRAM(0x00 + 18) == 0x00);
+	CHECK(MIC_Sim.DDRAM(0x40 + 18) == 0x01);
+	CHECK(MIC_Sim.DDRAM(0x14 + 18) == 0x20);
+	CHECK(MIC_Sim.DDRAM(0x54 + 18) == 0x01);
+	CHECK(MIC_Sim.DDRAM(0x54 + 19) == 0xff);
+
+	_checkBus();
+
+	return;
+}
+
+// Console paging by a full screen on 20x4
+static void testConsole(void)
+{
+	CHAR8 history[8 * 20];
+	CHAR8 line[24];
+	BYTE counter = 0;
+
+	printf("testConsole\n");
+
+	MIC_Sim.powerOn();
+	MIC_Sim.attach595(SIM_LATCH);
+	MIC_LCD lcd(SIM_LATCH);
+	MIC_LCDConsole console(&lcd, history, sizeof(history));
+
+	CHECK(lcd.PORST(4, 20) == MIC_RC_SUCCESS);
+
+	for (counter = 1; counter <= 10; counter++)
+	{
+		snprintf(line, sizeof(line), "line %d", counter);
+		CHECK(console.print(line) == MIC_RC_SUCCESS);
+	}
+	CHECK(_shows(0x00, "line 7              "));
+	CHECK(_shows(0x54, "line 10             "));
+
+	// Lines 3 - 10 are kept, one page back shows lines 3 - 6
+	CHECK(console.pageUp() == MIC_RC_SUCCESS);
+	CHECK(_shows(0x00, "line 3              "));
+	CHECK(_shows(0x40, "line 4              "));
+	CHECK(_shows(0x14, "line 5              "));
+	CHECK(_shows(0x54, "line 6              "));
+	CHECK(console.pageUp() == MIC_RC_SUCCESS);
+	CHECK(_shows(0x00, "line 3              "));
+
+	// New line keeps the scrolled back view on the same lines
+	CHECK(console.print((CHAR8 *)"line 11") == MIC_RC_SUCCESS);
+	CHECK(_shows(0x00, "line 4              "));
+	CHECK(_shows(0x54, "line 7              "));
+	CHECK(console.pageDown() == MIC_RC_SUCCESS);
+	CHECK(_shows(0x00, "line 8              "));
+	CHECK(_shows(0x54, "line 11             "));
+
+	_checkBus();
+
+	return;
+}
+
+static void testSlowOscillator(void)
+{
+	printf("testSlowOscillator\n");
+
+	MIC_Sim.oscillator(190);
+	MIC_Sim.powerOn();
+	MIC_Sim.attach595(SIM_LATCH);
+	MIC_LCD lcd(SIM_LATCH);
+
+	CHECK(lcd.PORST(2, 16) == MIC_RC_SUCCESS);
+	CHECK(lcd.displayStr(1, 1, (CHAR8 *)"190kHz", 6) == MIC_RC_SUCCESS);
+	CHECK(lcd.clearDisplay() == MIC_RC_SUCCESS);
+	CHECK(lcd.displayStr(2, 1, (CHAR8 *)"slow", 4) == MIC_RC_SUCCESS);
+	CHECK(_shows(0x00, "      "));
+	CHECK(_shows(0x40, "slow"));
+
+	_checkBus();
+
+	// Busy flag polled on a parallel bus, clear display is not taken for a hung LCD
+	MIC_Sim.powerOn();
+	MIC_Sim.attachParallel(2, 3, 12, 7, 6, 5, 4, 0xff, 0xff, 0xff, 0xff);
+	MIC_LCD lcdRW(2, 3, 12, 7, 6, 5, 4, 0xff, 0xff, 0xff, 0xff);
+	MIC_LCD_HEALTH health;
+
+	CHECK(lcdRW.PORST(2, 16) == MIC_RC_SUCCESS);
+	CHECK(lcdRW.displayStr(1, 1, (CHAR8 *)"190kHz", 6) == MIC_RC_SUCCESS);
+	CHECK(lcdRW.clearDisplay() == MIC_RC_SUCCESS);
+	CHECK(lcdRW.displayStr(2, 1, (CHAR8 *)"busy", 4) == MIC_RC_SUCCESS);
+	CHECK(_shows(0x40, "busy"));
+	lcdRW.getHealth(&health);
+	CHECK(health.state == MIC_LCD_HEALTH_OK);
+	CHECK(health.timeoutCount == 0);
+
+	_checkBus();
+	MIC_Sim.oscillator(MIC_LCDSIM_FOSC);
+
+	return;
+}
+
+static MIC_LCD *_healthLCD = NULL;
+static BYTE _recoveringSeen = CLEAR;
+
+// Hook of the simulated LCD, health state while instructions are executed
+static void _healthHook(BYTE rs, BYTE value)
+{
+	MIC_LCD_HEALTH health;
+
+	(void)rs;
+	(void)value;
+
+	_healthLCD->getHealth(&health);
+	if (health.state == MIC_LCD_HEALTH_RECOVERING)
+	{
+		_recoveringSeen = SET;
+	}
+
+	return;
+}
+
+// LCD hangs with busy flag set: OK -> FAILED -> probe -> RECOVERING -> OK
+static void testHealth(void)
+{
+	MIC_LCD_SNAPSHOT snapshot;
+	MIC_LCD_HEALTH health;
+	unsigned long startMicros = 0;
+
+	printf("testHealth\n");
+
+	MIC_Sim.powerOn();
+	MIC_Sim.attachParallel(2, 3, 12, 7, 6, 5, 4, 0xff, 0xff, 0xff, 0xff);
+	MIC_LCD lcd(2, 3, 12, 7, 6, 5, 4, 0xff, 0xff, 0xff, 0xff);
+
+	CHECK(lcd.PORST(2, 16) == MIC_RC_SUCCESS);
+	CHECK(lcd.attachSnapshot(&snapshot) == MIC_RC_SUCCESS);
+	CHECK(lcd.displayStr(1, 1, (CHAR8 *)"healthy", 7) == MIC_RC_SUCCESS);
+	CHECK(_shows(0x00, "healthy"));
+	lcd.getHealth(&health);
+	CHECK(health.state == MIC_LCD_HEALTH_OK);
+	CHECK(lcd.checkHealth() == MIC_RC_SUCCESS);
+
+	// First call waits the busy timeout, later calls fail at once
+	MIC_Sim.stuckBusy(SET);
+	startMicros = micros();
+	CHECK(lcd.displayStr(2, 1, (CHAR8 *)"lost", 4) != MIC_RC_SUCCESS);
+	CHECK((micros() - startMicros) >= MIC_LCD_BUSYTIMEOUT);
+	lcd.getHealth(&health);
+	CHECK(health.state == MIC_LCD_HEALTH_FAILED);
+	CHECK(health.timeoutCount == 1);
+
+	startMicros = micros();
+	CHECK(lcd.putChar('x') != MIC_RC_SUCCESS);
+	CHECK((micros() - startMicros) < (MIC_LCD_BUSYTIMEOUT / 4));
+	lcd.getHealth(&health);
+	CHECK(health.timeoutCount == 1);
+
+	// Probe waits the probe interval, busy flag still set counts a failed probe
+	CHECK(lcd.checkHealth() != MIC_RC_SUCCESS);
+	lcd.getHealth(&health);
+	CHECK(health.failedProbeCount == 0);
+
+	delay(MIC_LCD_PROBEINTERVAL + 10);
+	CHECK(lcd.checkHealth() != MIC_RC_SUCCESS);
+	lcd.getHealth(&health);
+	CHECK(health.state == MIC_LCD_HEALTH_FAILED);
+	CHECK(health.failedProbeCount == 1);
+	CHECK(health.recoveryCount == 0);
+
+	// LCD is back after a power loss, probe initializes it again and the screen is restored from the snapshot
+	MIC_Sim.stuckBusy(CLEAR);
+	MIC_Sim.powerOn();
+	_healthLCD = &lcd;
+	_recoveringSeen = CLEAR;
+	MIC_Sim.setHook(_healthHook);
+
+	delay(MIC_LCD_PROBEINTERVAL + 10);
+	CHECK(lcd.checkHealth() == MIC_RC_SUCCESS);
+	MIC_Sim.setHook(NULL);
+
+	CHECK(_recoveringSeen == SET);
+	lcd.getHealth(&health);
+	CHECK(health.state == MIC_LCD_HEALTH_OK);
+	CHECK(health.timeoutCount == 1);
+	CHECK(health.failedProbeCount == 1);
+	CHECK(health.recoveryCount == 1);
+	CHECK(_shows(0x00, "healthy "));
+	CHECK(MIC_Sim.bus8Bit() == CLEAR);
+
+	CHECK(lcd.displayStr(2, 1, (CHAR8 *)"back", 4) == MIC_RC_SUCCESS);
+	CHECK(_shows(0x40, "back"));
+
+	_checkBus();
+
+	return;
+}
+
+int main(void)
+{
+	testTransport595();
+	testParallel();
+	testSlowOscillator();
+	testEntryMode();
+	testAnimatorBudget();
+	testRecover();
+	testHealth();
+	testCompositor();
+	testScheduler();
+	testGeometry();
+	testBigNum();
+	testConsole();
+	testWideScreen();
+
+	printf("%s, %d failed checks\n", (_failures == 0) ? "PASS" : "FAIL", _failures);
+
+	return _failures;
+}
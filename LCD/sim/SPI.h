@@ -0,0 +1,26 @@
+#ifndef SPI_h
+#define SPI_h
+
+// Host stub of the Arduino SPI library, bytes are shifted into the simulated 74HC595 of MIC_LCDSim
+#include <stdint.h>
+
+#define SPI_MODE0	0
+
+class SPISettings
+{
+public:
+	SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) { (void)clock; (void)bitOrder; (void)dataMode; }
+};
+
+class SPIClass
+{
+public:
+	void begin(void);
+	void beginTransaction(SPISettings settings);
+	void endTransaction(void);
+	uint8_t transfer(uint8_t data);
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,508 @@
+// MIC_LCDScreenCompiler
+// Host tool, packs screen definitions into a compressed screen library header for MIC_LCDScreenDecoder.
+// Build: g++ -std=c++11 -O2 -o MIC_LCDScreenCompiler MIC_LCDScreenCompiler.cpp
+// Usage: MIC_LCDScreenCompiler <input.txt> <output.h> <NAME>
+//
+// Input format:
+//  # comment
+//  @size <rows> <columns>		must be the first definition
+//  @screen <ID>				followed by up to <rows> lines, each line is cut or padded with space to <columns>
+//  Escapes in screen lines: \xNN for any character code (e.g. \x00 - \x07 for CGRAM), \\ for backslash
+//
+// Output: NAME (MIC_LCD_SCREENLIB) and NAME_<ID> screen IDs, arrays in PROGMEM.
+// Screen code stream (see MIC_LCDScreenLib.h): space runs of 2 or more are run length coded, repeated substrings
+// across all screens are put in a shared dictionary of up to 64 entries. Identical screens share their code.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#define SCREEN_ESCAPE		0x00
+#define SCREEN_SPACERUN		0x80
+#define SCREEN_DICTIONARY	0xC0
+#define SCREEN_MAXRUN		64
+#define SCREEN_MAXDICTIONARY	64
+#define DICT_MINLEN			2
+#define DICT_MAXLEN			20
+#define INDEX_COST			2		// each dictionary entry costs one UINT16 in the dictionary index
+
+// Piece of a screen: literal text, space run or dictionary entry
+typedef struct
+{
+	int type;
+	std::string text;		// literal text
+	int value;				// run length or dictionary entry
+} PIECE;
+
+#define PIECE_TEXT			0
+#define PIECE_SPACES		1
+#define PIECE_DICTIONARY	2
+
+typedef struct
+{
+	std::string id;
+	std::string cells;		// rows * columns characters
+	std::vector<PIECE> pieces;
+} SCREEN;
+
+static int errorLine(const char *file, int line, const char *message)
+{
+	fprintf(stderr, "%s:%d: %s\n", file, line, message);
+	return 1;
+}
+
+// Function: bool parseLine(const std::string &line, int columns, std::string *cells)
+// Decode escapes, cut or pad with space to columns
+static bool parseLine(const std::string &line, int columns, std::string *cells)
+{
+	std::string row;
+	size_t counter = 0;
+	unsigned int code = 0;
+
+	for (counter = 0; counter < line.size(); counter++)
+	{
+		if (line[counter] != '\\')
+		{
+			row += line[counter];
+		}
+		else if ((counter + 1 < line.size()) && (line[counter + 1] == '\\'))
+		{
+			row += '\\';
+			counter++;
+		}
+		else if ((counter + 3 < line.size()) && (line[counter + 1] == 'x') && (sscanf(line.c_str() + counter + 2, "%2x", &code) == 1))
+		{
+			row += (char)code;
+			counter += 3;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	if ((int)row.size() > columns)
+	{
+		fprintf(stderr, "warning: line cut to %d columns: %s\n", columns, line.c_str());
+	}
+	row.resize(columns, ' ');
+	*cells += row;
+
+	return true;
+}
+
+// Function: void splitSpaces(SCREEN *screen)
+// First pieces of a screen: runs of 2 or more spaces, and literal text between them
+static void splitSpaces(SCREEN *screen)
+{
+	const std::string &cells = screen->cells;
+	size_t position = 0;
+	size_t end = 0;
+	PIECE piece;
+
+	while (position < cells.size())
+	{
+		end = position;
+		while ((end < cells.size()) && (cells[end] == ' '))
+		{
+			end++;
+		}
+
+		if ((end - position) >= 2)
+		{
+			piece.type = PIECE_SPACES;
+			piece.text.clear();
+			piece.value = (int)(end - position);
+			screen->pieces.push_back(piece);
+			position = end;
+			continue;
+		}
+
+		end = position + 1;
+		while ((end < cells.size()) && !((cells[end] == ' ') && (end + 1 < cells.size()) && (cells[end + 1] == ' ')))
+		{
+			end++;
+		}
+
+		piece.type = PIECE_TEXT;
+		piece.text = cells.substr(position, end - position);
+		piece.value = 0;
+		screen->pieces.push_back(piece);
+		position = end;
+	}
+}
+
+// Function: int literalCost(const std::string &text)
+// Bytes needed to code text as literal characters
+static int literalCost(const std::string &text)
+{
+	int cost = 0;
+	size_t counter = 0;
+
+	for (counter = 0; counter < text.size(); counter++)
+	{
+		cost += ((text[counter] == 0) || ((unsigned char)text[counter] >= 0x80)) ? 2 : 1;
+	}
+
+	return cost;
+}
+
+// Function: bool pickEntry(std::vector<SCREEN> &screens, std::string *entry)
+// Find the substring of literal text saving most bytes when moved to dictionary
+// Uses are counted left to right without overlap within a piece, as replaceEntry will replace them.
+static bool pickEntry(std::vector<SCREEN> &screens, std::string *entry)
+{
+	std::map<std::string, int> count;
+	std::map<std::string, int>::iterator item;
+	std::map<std::string, size_t> nextStart;		// first start in the piece after the last counted use
+	std::map<std::string, size_t>::iterator last;
+	size_t screen = 0;
+	size_t piece = 0;
+	size_t start = 0;
+	size_t length = 0;
+	int saving = 0;
+	int bestSaving = 0;
+
+	for (screen = 0; screen < screens.size(); screen++)
+	{
+		for (piece = 0; piece < screens[screen].pieces.size(); piece++)
+		{
+			const std::string &text = screens[screen].pieces[piece].text;
+
+			if (screens[screen].pieces[piece].type != PIECE_TEXT)
+			{
+				continue;
+			}
+
+			nextStart.clear();
+
+			for (start = 0; start < text.size(); start++)
+			{
+				for (length = DICT_MINLEN; (length <= DICT_MAXLEN) && (start + length <= text.size()); length++)
+				{
+					const std::string use = text.substr(start, length);
+
+					last = nextStart.find(use);
+					if ((last == nextStart.end()) || (start >= last->second))
+					{
+						count[use]++;
+						nextStart[use] = start + length;
+					}
+				}
+			}
+		}
+	}
+
+	for (item = count.begin(); item != count.end(); item++)
+	{
+		// Every use saves its literal cost minus one code byte, the entry itself is stored once
+		saving = (item->second * (literalCost(item->first) - 1)) - ((int)item->first.size() + INDEX_COST);
+
+		if ((saving > bestSaving) || ((saving == bestSaving) && (saving > 0) && (item->first.size() > entry->size())))
+		{
+			bestSaving = saving;
+			*entry = item->first;
+		}
+	}
+
+	return (bestSaving > 0);
+}
+
+// Function: int replaceEntry(std::vector<SCREEN> &screens, const std::string &entry, int value)
+// Replace non-overlapping uses of entry in literal text by a dictionary piece, return number of uses
+static int replaceEntry(std::vector<SCREEN> &screens, const std::string &entry, int value)
+{
+	std::vector<PIECE> pieces;
+	PIECE piece;
+	size_t screen = 0;
+	size_t counter = 0;
+	size_t position = 0;
+	size_t found = 0;
+	int uses = 0;
+
+	for (screen = 0; screen < screens.size(); screen++)
+	{
+		pieces.clear();
+
+		for (counter = 0; counter < screens[screen].pieces.size(); counter++)
+		{
+			const PIECE &old = screens[screen].pieces[counter];
+
+			if (old.type != PIECE_TEXT)
+			{
+				pieces.push_back(old);
+				continue;
+			}
+
+			position = 0;
+			while ((found = old.text.find(entry, position)) != std::string::npos)
+			{
+				if (found > position)
+				{
+					piece.type = PIECE_TEXT;
+					piece.text = old.text.substr(position, found - position);
+					piece.value = 0;
+					pieces.push_back(piece);
+				}
+
+				piece.type = PIECE_DICTIONARY;
+				piece.text.clear();
+				piece.value = value;
+				pieces.push_back(piece);
+
+				position = found + entry.size();
+				uses++;
+			}
+
+			if (position < old.text.size())
+			{
+				piece.type = PIECE_TEXT;
+				piece.text = old.text.substr(position);
+				piece.value = 0;
+				pieces.push_back(piece);
+			}
+		}
+
+		screens[screen].pieces = pieces;
+	}
+
+	return uses;
+}
+
+// Function: std::string encode(const SCREEN &screen)
+// Code stream of a screen
+static std::string encode(const SCREEN &screen)
+{
+	std::string code;
+	size_t counter = 0;
+	size_t character = 0;
+	int run = 0;
+
+	for (counter = 0; counter < screen.pieces.size(); counter++)
+	{
+		const PIECE &piece = screen.pieces[counter];
+
+		if (piece.type == PIECE_SPACES)
+		{
+			run = piece.value;
+			while (run > 0)
+			{
+				code += (char)(SCREEN_SPACERUN | (((run > SCREEN_MAXRUN) ? SCREEN_MAXRUN : run) - 1));
+				run -= SCREEN_MAXRUN;
+			}
+		}
+		else if (piece.type == PIECE_DICTIONARY)
+		{
+			code += (char)(SCREEN_DICTIONARY | piece.value);
+		}
+		else
+		{
+			for (character = 0; character < piece.text.size(); character++)
+			{
+				if ((piece.text[character] == SCREEN_ESCAPE) || ((unsigned char)piece.text[character] >= 0x80))
+				{
+					code += (char)SCREEN_ESCAPE;
+				}
+				code += piece.text[character];
+			}
+		}
+	}
+
+	return code;
+}
+
+static void writeBytes(FILE *output, const std::string &bytes)
+{
+	size_t counter = 0;
+
+	for (counter = 0; counter < bytes.size(); counter++)
+	{
+		fprintf(output, "%s0x%02X,", ((counter % 16) == 0) ? "\n\t" : " ", (unsigned char)bytes[counter]);
+	}
+	fprintf(output, "\n");
+}
+
+static void writeWords(FILE *output, const std::vector<int> &words)
+{
+	size_t counter = 0;
+
+	for (counter = 0; counter < words.size(); counter++)
+	{
+		fprintf(output, "%s%d,", ((counter % 12) == 0) ? "\n\t" : " ", words[counter]);
+	}
+	fprintf(output, "\n");
+}
+
+int main(int argc, char *argv[])
+{
+	std::vector<SCREEN> screens;
+	std::vector<std::string> dictionary;
+	std::map<std::string, int> screenCode;
+	std::string data;
+	std::string dictData;
+	std::string code;
+	std::string entry;
+	std::vector<int> screenIndex;
+	std::vector<int> dictIndex;
+	SCREEN screen;
+	FILE *input = NULL;
+	FILE *output = NULL;
+	char buffer[512];
+	std::string line;
+	int rows = 0;
+	int columns = 0;
+	int lineNumber = 0;
+	int rowCount = 0;
+	size_t counter = 0;
+	size_t cellCount = 0;
+
+	if (argc != 4)
+	{
+		fprintf(stderr, "Usage: %s <input.txt> <output.h> <NAME>\n", argv[0]);
+		return 1;
+	}
+
+	input = fopen(argv[1], "r");
+	if (input == NULL)
+	{
+		perror(argv[1]);
+		return 1;
+	}
+
+	// Parse screen definitions
+	while (fgets(buffer, sizeof(buffer), input) != NULL)
+	{
+		lineNumber++;
+		line = buffer;
+		while (!line.empty() && ((line[line.size() - 1] == '\n') || (line[line.size() - 1] == '\r')))
+		{
+			line.erase(line.size() - 1);
+		}
+
+		if ((screens.empty() || (rowCount >= rows)) && (line.empty() || (line[0] == '#')))
+		{
+			continue;
+		}
+
+		if (line.compare(0, 6, "@size ") == 0)
+		{
+			if ((sscanf(line.c_str() + 6, "%d %d", &rows, &columns) != 2) || (rows < 1) || (rows > 4) || (columns < 1) || (columns > 40) || ((rows * columns) > 80))
+			{
+				return errorLine(argv[1], lineNumber, "bad @size");
+			}
+		}
+		else if (line.compare(0, 8, "@screen ") == 0)
+		{
+			if (rows == 0)
+			{
+				return errorLine(argv[1], lineNumber, "@size should come first");
+			}
+			screen.id = line.substr(8);
+			screen.cells.clear();
+			screen.pieces.clear();
+			screens.push_back(screen);
+			rowCount = 0;
+		}
+		else if (screens.empty() || (rowCount >= rows))
+		{
+			return errorLine(argv[1], lineNumber, "line outside of a screen");
+		}
+		else
+		{
+			if (!parseLine(line, columns, &screens.back().cells))
+			{
+				return errorLine(argv[1], lineNumber, "bad escape");
+			}
+			rowCount++;
+		}
+	}
+	fclose(input);
+
+	if (screens.empty())
+	{
+		fprintf(stderr, "%s: no screen\n", argv[1]);
+		return 1;
+	}
+
+	// Missing lines are blank
+	for (counter = 0; counter < screens.size(); counter++)
+	{
+		screens[counter].cells.resize(rows * columns, ' ');
+		splitSpaces(&screens[counter]);
+		cellCount += screens[counter].cells.size();
+	}
+
+	// Shared dictionary, most saving substring first
+	while ((dictionary.size() < SCREEN_MAXDICTIONARY) && pickEntry(screens, &entry))
+	{
+		replaceEntry(screens, entry, (int)dictionary.size());
+		dictionary.push_back(entry);
+		entry.clear();
+	}
+
+	for (counter = 0; counter < dictionary.size(); counter++)
+	{
+		dictIndex.push_back((int)dictData.size());
+		dictData += dictionary[counter];
+	}
+	dictIndex.push_back((int)dictData.size());
+
+	// Screen code, identical screens share one copy
+	for (counter = 0; counter < screens.size(); counter++)
+	{
+		code = encode(screens[counter]);
+
+		if (screenCode.find(code) == screenCode.end())
+		{
+			screenCode[code] = (int)data.size();
+			data += code;
+		}
+		screenIndex.push_back(screenCode[code]);
+	}
+
+	if ((data.size() > 0xffff) || (dictData.size() > 0xffff))
+	{
+		fprintf(stderr, "%s: screen data is bigger than 64KB, split it into more libraries\n", argv[1]);
+		return 1;
+	}
+
+	output = fopen(argv[2], "w");
+	if (output == NULL)
+	{
+		perror(argv[2]);
+		return 1;
+	}
+
+	fprintf(output, "// Generated by MIC_LCDScreenCompiler from %s, do not edit\n", argv[1]);
+	fprintf(output, "// %u screens (%dx%d), %u characters packed into %u bytes, %u dictionary entries (%u bytes)\n",
+		(unsigned)screens.size(), rows, columns, (unsigned)cellCount, (unsigned)data.size(), (unsigned)dictionary.size(), (unsigned)dictData.size());
+	fprintf(output, "#ifndef %s_h\n#define %s_h\n\n", argv[3], argv[3]);
+
+	for (counter = 0; counter < screens.size(); counter++)
+	{
+		fprintf(output, "#define %s_%s\t%u\n", argv[3], screens[counter].id.c_str(), (unsigned)counter);
+	}
+
+	fprintf(output, "\nconst BYTE %s_screenData[] PROGMEM = {", argv[3]);
+	writeBytes(output, data);
+	fprintf(output, "};\n\nconst UINT16 %s_screenIndex[] PROGMEM = {", argv[3]);
+	writeWords(output, screenIndex);
+	fprintf(output, "};\n\nconst BYTE %s_dictData[] PROGMEM = {", argv[3]);
+	writeBytes(output, dictData.empty() ? std::string(1, '\0') : dictData);
+	fprintf(output, "};\n\nconst UINT16 %s_dictIndex[] PROGMEM = {", argv[3]);
+	writeWords(output, dictIndex);
+	fprintf(output, "};\n\n");
+
+	fprintf(output, "const MIC_LCD_SCREENLIB %s = {%d, %d, %u, %s_screenIndex, %s_screenData, %s_dictIndex, %s_dictData};\n\n",
+		argv[3], rows, columns, (unsigned)screens.size(), argv[3], argv[3], argv[3], argv[3]);
+	fprintf(output, "#endif\n");
+	fclose(output);
+
+	fprintf(stderr, "%u screens, %u characters packed into %u + %u bytes\n",
+		(unsigned)screens.size(), (unsigned)cellCount, (unsigned)data.size(), (unsigned)dictData.size());
+
+	return 0;
+}